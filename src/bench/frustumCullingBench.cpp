@@ -0,0 +1,91 @@
+// ============================================================
+// 视锥裁剪微基准：标量 Frustum::intersects（AoS 逐个测试）
+// vs Frustum::intersectsBatch（SoA + SSE/AVX2）
+// 用法：FrustumCullingBench [盒子数量] [重复次数]
+// ============================================================
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../include/terrain/frustumCulling.hpp"
+
+// 当前编译启用的批量路径
+static const char* simdPathName() {
+#if defined(FRUSTUM_SIMD_AVX2)
+    return "AVX2 (8 lanes)";
+#elif defined(FRUSTUM_SIMD_SSE)
+    return "SSE (4 lanes)";
+#else
+    return "scalar fallback";
+#endif
+}
+
+int main(int argc, char** argv) {
+    const int boxCount = (argc > 1) ? std::atoi(argv[1]) : 65536;
+    const int repeats = (argc > 2) ? std::atoi(argv[2]) : 200;
+
+    // 与地形规模相当的场景：盒子散布在 4096 x 4096 的平面上，高度 0~1800
+    std::mt19937 rng(20260120);
+    std::uniform_real_distribution<float> posXZ(-2048.0f, 2048.0f);
+    std::uniform_real_distribution<float> posY(0.0f, 1800.0f);
+    std::uniform_real_distribution<float> ext(1.0f, 40.0f);
+
+    std::vector<AABB> aos;
+    AABBSoA soa;
+    aos.reserve(boxCount);
+    soa.reserve(boxCount);
+    for (int i = 0; i < boxCount; ++i) {
+        glm::vec3 c(posXZ(rng), posY(rng), posXZ(rng));
+        glm::vec3 e(ext(rng), ext(rng), ext(rng));
+        AABB b{ c - e, c + e };
+        aos.push_back(b);
+        soa.push_back(b);
+    }
+
+    // 与 main.cpp 一致的投影参数
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 800.0f / 600.0f, 2.0f, 5000.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 1200.0f, 0.0f), glm::vec3(300.0f, 1000.0f, -1000.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum;
+    frustum.updateFromMatrix(projection * view);
+
+    std::vector<int> scalarVisible, batchVisible;
+    scalarVisible.reserve(boxCount);
+    batchVisible.reserve(boxCount);
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    // ---- 标量 ----
+    auto t0 = Clock::now();
+    for (int r = 0; r < repeats; ++r) {
+        scalarVisible.clear();
+        for (int i = 0; i < boxCount; ++i) {
+            if (frustum.intersects(aos[i])) scalarVisible.push_back(i);
+        }
+    }
+    auto t1 = Clock::now();
+
+    // ---- 批量 SoA ----
+    for (int r = 0; r < repeats; ++r) {
+        batchVisible.clear();
+        frustum.intersectsBatch(soa, batchVisible);
+    }
+    auto t2 = Clock::now();
+
+    double scalarMs = std::chrono::duration<double, std::milli>(t1 - t0).count() / repeats;
+    double batchMs = std::chrono::duration<double, std::milli>(t2 - t1).count() / repeats;
+
+    std::cout << "[FrustumCullingBench] boxes=" << boxCount << " repeats=" << repeats
+        << " path=" << simdPathName() << std::endl;
+    std::cout << "  visible: scalar=" << scalarVisible.size() << " batch=" << batchVisible.size()
+        << (scalarVisible == batchVisible ? " (match)" : " (MISMATCH)") << std::endl;
+    std::cout << "  scalar : " << scalarMs << " ms/frame, " << scalarMs * 1e6 / boxCount << " ns/box" << std::endl;
+    std::cout << "  batch  : " << batchMs << " ms/frame, " << batchMs * 1e6 / boxCount << " ns/box" << std::endl;
+    std::cout << "  speedup: " << (batchMs > 0.0 ? scalarMs / batchMs : 0.0) << "x" << std::endl;
+
+    return scalarVisible == batchVisible ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+// ============================================================
+// 地形射线微基准：TerrainRaycaster 金字塔加速 vs 逐单元线性步进
+// 随机射线从地形上空射向各个方向（多数朝下），先在子集上与线性参考实现对比结果，
+// 再用 raycastBatch 在线程池上跑完全部射线。
+// 用法：TerrainRaycastBench [射线数量] [校验子集数量] [heightmap 路径]
+// ============================================================
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+#include <glm/glm.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../include/stb_image.h"
+#include "../include/terrain/terrainRaycast.hpp"
+
+int main(int argc, char** argv) {
+    const int rayCount = (argc > 1) ? std::atoi(argv[1]) : 1000000;
+    const int checkCount = std::min(rayCount, (argc > 2) ? std::atoi(argv[2]) : 20000);
+    const std::string path = (argc > 3) ? argv[3] : ASSETS_FOLDER "terrain/heightmap_2049.png";
+
+    // 与 main.cpp 一致的地形参数
+    const float heightScale = 1800.0f;
+    const float gridScale = 1.0f;
+    Heightmap heightmap(path, heightScale);
+    TerrainRaycaster raycaster(heightmap, gridScale);
+
+    const float halfW = (heightmap.width - 1) * gridScale * 0.5f;
+    const float halfH = (heightmap.height - 1) * gridScale * 0.5f;
+
+    // 起点：地形上空随机位置；方向：随机，y 偏向下方
+    std::mt19937 rng(20260121);
+    std::uniform_real_distribution<float> posX(-halfW, halfW);
+    std::uniform_real_distribution<float> posZ(-halfH, halfH);
+    std::uniform_real_distribution<float> posY(0.0f, heightScale * 1.5f);
+    std::uniform_real_distribution<float> dirXZ(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> dirY(-1.0f, 0.2f);
+
+    std::vector<TerrainRay> rays(rayCount);
+    for (auto& ray : rays) {
+        ray.origin = glm::vec3(posX(rng), posY(rng), posZ(rng));
+        ray.dir = glm::vec3(dirXZ(rng), dirY(rng), dirXZ(rng));
+        ray.maxDist = 4000.0f;
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    // ---- 子集：单线程线性 vs 单线程金字塔，并逐条对比 ----
+    std::vector<TerrainRayHit> linearHits(checkCount), fastHits(checkCount);
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < checkCount; ++i) {
+        linearHits[i] = raycaster.raycastLinear(rays[i].origin, rays[i].dir, rays[i].maxDist);
+    }
+    auto t1 = Clock::now();
+    for (int i = 0; i < checkCount; ++i) {
+        fastHits[i] = raycaster.raycast(rays[i].origin, rays[i].dir, rays[i].maxDist);
+    }
+    auto t2 = Clock::now();
+
+    int mismatches = 0, hitCount = 0;
+    for (int i = 0; i < checkCount; ++i) {
+        const TerrainRayHit& a = linearHits[i];
+        const TerrainRayHit& b = fastHits[i];
+        if (a.hit) ++hitCount;
+        if (a.hit != b.hit || (a.hit && std::fabs(a.distance - b.distance) > 1e-2f)) ++mismatches;
+    }
+
+    double linearNs = std::chrono::duration<double, std::nano>(t1 - t0).count() / checkCount;
+    double fastNs = std::chrono::duration<double, std::nano>(t2 - t1).count() / checkCount;
+
+    // ---- 全部射线：raycastBatch（线程池） ----
+    std::vector<TerrainRayHit> hits;
+    auto t3 = Clock::now();
+    raycaster.raycastBatch(rays, hits);
+    auto t4 = Clock::now();
+    double batchMs = std::chrono::duration<double, std::milli>(t4 - t3).count();
+
+    int batchHits = 0;
+    for (const auto& h : hits) batchHits += h.hit ? 1 : 0;
+
+    std::cout << "[TerrainRaycastBench] heightmap=" << heightmap.width << "x" << heightmap.height
+        << " rays=" << rayCount << " checked=" << checkCount << std::endl;
+    std::cout << "  check  : hits=" << hitCount << " mismatches=" << mismatches
+        << (mismatches == 0 ? " (match)" : " (MISMATCH)") << std::endl;
+    std::cout << "  linear : " << linearNs << " ns/ray (single thread)" << std::endl;
+    std::cout << "  pyramid: " << fastNs << " ns/ray (single thread), speedup "
+        << (fastNs > 0.0 ? linearNs / fastNs : 0.0) << "x" << std::endl;
+    std::cout << "  batch  : " << batchMs << " ms for " << rayCount << " rays on "
+        << ThreadPool::shared().size() + 1 << " threads (" << batchMs * 1e6 / rayCount << " ns/ray), hits="
+        << batchHits << std::endl;
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -10,7 +10,7 @@
 #include <assimp/postprocess.h>
 #include "include/shader.hpp"
 
-//  ݽṹ 
+// ———————— 数据结构 ————————
 
 struct AniVertex {
     glm::vec3 Position;
@@ -18,7 +18,7 @@ struct AniVertex {
     glm::vec2 TexCoords;
 };
 
-// ̬
+// 形态键数据
 struct MorphTarget {
     std::vector<glm::vec3> Positions;
     std::vector<glm::vec3> Normals;
@@ -30,14 +30,14 @@ struct AniTexture {
     aiString path;
 };
 
-//  Mesh  
+// ———————— Mesh 类 ————————
 
 class AniMesh {
 public:
     std::vector<AniVertex> vertices;
     std::vector<unsigned int> indices;
     std::vector<AniTexture> textures;
-    std::vector<MorphTarget> morphTargets; // 洢 Mesh ̬
+    std::vector<MorphTarget> morphTargets; // 存储该 Mesh 的所有形态键
     unsigned int VAO, VBO, EBO;
     glm::vec3 baseColor;
 
@@ -67,7 +67,7 @@ public:
         glBindVertexArray(0);
     }
 
-    // ֵ̬
+    // 更新形态键插值
     void updateMorphAnimation(const std::vector<float>& weights) {
         if (morphTargets.empty() || weights.empty()) return;
 
@@ -103,7 +103,7 @@ public:
     }
 };
 
-//  Model  
+// ———————— Model 类 ————————
 
 class AniModel {
 public:
@@ -111,7 +111,7 @@ public:
     Assimp::Importer importer;
     const aiScene* scene = nullptr;
     std::string TEXTURES_DIR;
-    int externalState = 0; // ״̬0 idle, 1 walk, 2 run
+    int externalState = 0; // 状态机0 idle, 1 walk, 2 run
 
     AniModel(const std::string& path, const std::string& texture_path) : TEXTURES_DIR(texture_path) {
         loadModel(path);
@@ -124,16 +124,16 @@ public:
     std::vector<float> generateGaussianWaveWeights(float currentTimeMs, int numMorphs, float totalDurationMs, float sigma) {
         std::vector<float> weights(numMorphs, 0.0f);
 
-        // 1. ѭʱ䴦
+        // 1. 循环时间处理
         float loopTime = fmod(currentTimeMs, totalDurationMs);
         if (loopTime < 0) loopTime += totalDurationMs;
 
-        // 2.  mu
+        // 2. 计算中心索引 mu
         float mu = (loopTime / totalDurationMs) * static_cast<float>(numMorphs);
 
         float twoSigmaSq = 2.0f * sigma * sigma;
 
-        // 3. 
+        // 3. 遍历计算
         for (int i = 0; i < numMorphs; ++i) {
             float diff = static_cast<float>(i) - mu;
 
@@ -147,7 +147,7 @@ public:
 
     void UpdateAndDraw(Shader& shader, float currentTime, glm::mat4 baseTransform) {
         if (!scene || scene->mNumAnimations == 0) {
-            // ûֱӻ̬
+            // 如果没动画，直接画静态的
             std::cout << "no animation" << std::endl;
             drawNode(scene->mRootNode, shader, baseTransform);
             return;
@@ -155,39 +155,39 @@ public:
 
         const aiAnimation* anim = scene->mAnimations[0];
 
-        // ȷ ticksPerSecond Ч
+        // 确保 ticksPerSecond 有效
         float ticksPerSecond = (float)(anim->mTicksPerSecond != 0 ? anim->mTicksPerSecond : 25.0f);
         float timeInTicks = currentTime * ticksPerSecond;
 
-        // ģfmod ȷʱ 0 ֮ܳѭ
+        // 核心：fmod 确保时间在 0 到总长度之间循环
         float animationTime = fmod(timeInTicks, (float)anim->mDuration);
 
         std::cout << "Anim Time: " << animationTime << std::endl;
 
-        // ǿв
+        // 强行测试
         float time = glfwGetTime();
         std::vector<float> testWeights(311, 0.0f);
-        // ҡͷ
+        // 摇头
         //for (int i = 0; i < 5; i++) {
         //    testWeights[i] = (sin(time * 3.0f + i) + 1.0f) * 0.5f;
         //}
 
-        // ʹҲģԼ 3-4 
-        //float breath = (sin(time * 1.5f) + 1.0f) * 0.5f; // ŵ 0.0 - 1.0
-        //  10 زţ11 Ǽ΢̧
-        //testWeights[10] = breath * 0.3f; // Ȳ˹
+        // 使用正弦波模拟呼吸，周期约 3-4 秒
+        //float breath = (sin(time * 1.5f) + 1.0f) * 0.5f; // 缩放到 0.0 - 1.0
+        // 假设索引 10 是胸部扩张，11 是肩膀微抬
+        //testWeights[10] = breath * 0.3f; // 呼吸幅度不宜过大
         //testWeights[11] = breath * 0.1f;
 
-        // ˹Ȩ
-        // 
+        // 高斯波权重
+        // 完整动作
         //testWeights = generateGaussianWaveWeights(time * 1000.0f, 311, 13000.0f, 1.0f);
-        // ҡͷ
+        // 好奇版摇头
         //std::vector<float> newWeights = generateGaussianWaveWeights(time * 1000.0f, 200, 8360.0f, 1.0f);
         //std::copy(newWeights.begin(), newWeights.begin() + 200, testWeights.begin());
-        // ܲ
+        // 跑步
         //std::vector<float> newWeights = generateGaussianWaveWeights(time * 1000.0f, 32, 1338.0f, 1.0f);
         //std::copy(newWeights.begin(), newWeights.begin() + 32, testWeights.begin()+210);
-        // ·
+        // 走路
         //std::vector<float> newWeights = generateGaussianWaveWeights(time * 1000.0f, 50, 2075.0f, 1.0f);
         //std::copy(newWeights.begin(), newWeights.begin() + 50, testWeights.begin() + 260);
         
@@ -199,7 +199,7 @@ public:
             auto w = generateGaussianWaveWeights(time * 1000.0f, 50, 2075.0f, 1.0f);
             std::copy(w.begin(), w.end(), testWeights.begin() + 260);
         }
-        else {                             // IDLE (ҡͷ)
+        else {                             // IDLE (摇头)
             auto w = generateGaussianWaveWeights(time * 1000.0f, 20, 4000.0f, 1.0f);
             std::copy(w.begin(), w.end(), testWeights.begin());
             //testWeights = generateGaussianWaveWeights(time * 1000.0f, 311, 13000.0f, 1.0f);
@@ -249,7 +249,7 @@ private:
 
     unsigned int TextureFromFile(const char* path, const std::string& directory) {
         std::string filename = std::string(path);
-        filename = directory + "/" + filename; // ƴ·
+        filename = directory + "/" + filename; // 拼接完整路径
 
         unsigned int textureID;
         glGenTextures(1, &textureID);
@@ -271,7 +271,7 @@ private:
             glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
             glGenerateMipmap(GL_TEXTURE_2D);
 
-            // 
+            // 设置纹理参数
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
@@ -306,7 +306,7 @@ private:
         aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
         std::vector<AniTexture> textures;
 
-        //  Diffuse ͼ
+        // 加载 Diffuse 贴图
         for (unsigned int i = 0; i < material->GetTextureCount(aiTextureType_DIFFUSE); i++) {
             aiString str;
             material->GetTexture(aiTextureType_DIFFUSE, i, &str);
@@ -317,25 +317,25 @@ private:
             textures.push_back(texture);
         }
 
-        // ʹüص textures ʼ Mesh
+        // 使用加载到的 textures 初始化 Mesh
         AniMesh newMesh(vertices, indices, textures, glm::vec3(1.0f));
 
-        // --- ̬ ---
+        // --- 加载形态键 ---
         for (unsigned int i = 0; i < mesh->mNumAnimMeshes; i++) {
             aiAnimMesh* animMesh = mesh->mAnimMeshes[i];
             MorphTarget target;
             for (unsigned int j = 0; j < animMesh->mNumVertices; j++) {
-                // Assimp 洢
+                // Assimp 存储的是增量
                 target.Positions.push_back(glm::vec3(animMesh->mVertices[j].x, animMesh->mVertices[j].y, animMesh->mVertices[j].z) - vertices[j].Position);
             }
             newMesh.morphTargets.push_back(target);
         }
-        //  processMesh ĩβ
+        // 在 processMesh 函数末尾
         std::cout << "Mesh: " << mesh->mName.C_Str() << " has " << mesh->mNumAnimMeshes << " morph targets." << std::endl;
         return newMesh;
     }
 
-    // --- 1. ݹȾ ---
+    // --- 1. 基础递归渲染 ---
     void drawNode(aiNode* node, Shader& shader, glm::mat4 parentTransform) {
         glm::mat4 nodeTransform = convertMatrixToGLM(node->mTransformation);
         glm::mat4 globalTransform = parentTransform * nodeTransform;
@@ -349,14 +349,14 @@ private:
             drawNode(node->mChildren[i], shader, globalTransform);
         }
     }
-    // --- 2. ݹȾ ---
+    // --- 2. 动画递归渲染 ---
     void drawAnimatedNode(aiNode* node, Shader& shader, glm::mat4 parentTransform, float animationTime) {
         std::string nodeName(node->mName.data);
         glm::mat4 nodeTransform = convertMatrixToGLM(node->mTransformation);
 
         const aiAnimation* anim = scene->mAnimations[0];
 
-        // 1. ڵλƶ
+        // 1. 处理节点位移动画
         const aiNodeAnim* nodeAnim = findNodeAnim(anim, nodeName);
         if (nodeAnim) {
             glm::vec3 translation = interpolatePosition(animationTime, nodeAnim);
@@ -367,15 +367,15 @@ private:
 
         glm::mat4 globalTransform = parentTransform * nodeTransform;
 
-        // 2. ýڵ Meshes  Morph
+        // 2. 处理该节点的 Meshes 和 Morph
         for (unsigned int i = 0; i < node->mNumMeshes; i++) {
             int meshIdx = node->mMeshes[i];
             AniMesh& mesh = meshes[meshIdx];
 
-            // ̬Ȩؿܴ洢롰ڵMeshͬͨ
+            // 形态键权重可能存储在与“节点名”或“Mesh名”相同的通道中
             std::vector<float> allWeights;
 
-            //  MeshChannelsѰƥ䵱ǰڵȨ
+            // 遍历所有 MeshChannels，寻找匹配当前节点的权重
             for (unsigned int j = 0; j < anim->mNumMeshChannels; j++) {
                 if (std::string(anim->mMeshChannels[j]->mName.data) == nodeName) {
                     std::vector<float> w = interpolateWeights(animationTime, anim->mMeshChannels[j]);
@@ -396,7 +396,7 @@ private:
         }
     }
 
-    // --- ߺ ---
+    // --- 辅助工具函数 ---
     const aiNodeAnim* findNodeAnim(const aiAnimation* anim, std::string name) {
         for (unsigned int i = 0; i < anim->mNumChannels; i++) {
             if (std::string(anim->mChannels[i]->mNodeName.data) == name) return anim->mChannels[i];
@@ -415,7 +415,7 @@ private:
         std::vector<float> w;
         if (!anim || anim->mNumKeys == 0) return w;
 
-        // ҵǰʱӦĹؼ֡
+        // 找到当前时间对应的关键帧
         unsigned int frame = 0;
         for (unsigned int i = 0; i < anim->mNumKeys - 1; i++) {
             if (time < (float)anim->mKeys[i + 1].mTime) {
@@ -424,7 +424,7 @@ private:
             }
         }
 
-        // ֵ
+        // 计算插值因子
         unsigned int nextFrame = (frame + 1) % anim->mNumKeys;
         float t1 = (float)anim->mKeys[frame].mTime;
         float t2 = (float)anim->mKeys[nextFrame].mTime;
@@ -437,7 +437,7 @@ private:
         return w;
     }
 
-    // ת
+    // 矩阵转换
     glm::mat4 convertMatrixToGLM(const aiMatrix4x4& from) {
         glm::mat4 to;
         to[0][0] = from.a1; to[1][0] = from.a2; to[2][0] = from.a3; to[3][0] = from.a4;
@@ -447,7 +447,7 @@ private:
         return to;
     }
 
-    // ֵ (Position, Rotation, Scale)
+    // 插值辅助 (Position, Rotation, Scale)
     glm::vec3 interpolatePosition(float time, const aiNodeAnim* anim) {
         if (anim->mNumPositionKeys == 1) return glm::vec3(anim->mPositionKeys[0].mValue.x, anim->mPositionKeys[0].mValue.y, anim->mPositionKeys[0].mValue.z);
         unsigned int i = 0;
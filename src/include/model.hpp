@@ -45,11 +45,44 @@ public:
     }
 
     void Draw(Shader& shader) {
+        bindMaterial(shader);
+
+        glBindVertexArray(VAO);
+        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // 实例化绘制：每实例的 mat4 来自 setInstanceBuffer 绑定的缓冲（属性 3~6）
+    void DrawInstanced(Shader& shader, int instanceCount) {
+        bindMaterial(shader);
+
+        glBindVertexArray(VAO);
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0, instanceCount);
+        glBindVertexArray(0);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    // 把每实例 mat4 缓冲挂到本 mesh 的 VAO 上：mat4 占属性 3~6 四个 vec4，每实例前进一次
+    void setInstanceBuffer(unsigned int instanceVBO) {
+        glBindVertexArray(VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        for (int c = 0; c < 4; ++c) {
+            glEnableVertexAttribArray(3 + c);
+            glVertexAttribPointer(3 + c, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * c));
+            glVertexAttribDivisor(3 + c, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+private:
+    void bindMaterial(Shader& shader) {
         shader.setVec3("Material_baseColor", baseColor);
 
         bool hasDiffuseMap = false;
 
-        // 󶨵һ diffuse  texture_diffuse1
+        // 仅绑定第一张 diffuse 到 texture_diffuse1
         for (unsigned int i = 0; i < textures.size(); i++) {
             glActiveTexture(GL_TEXTURE0 + i);
 
@@ -61,14 +94,8 @@ public:
         }
 
         shader.setBool("hasTexture", hasDiffuseMap);
-
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(indices.size()), GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
-        glActiveTexture(GL_TEXTURE0);
     }
 
-private:
     void setupMesh() {
         glGenVertexArrays(1, &VAO);
         glGenBuffers(1, &VBO);
@@ -142,7 +169,7 @@ inline unsigned int TextureFromMemory(const aiTexture* aiTex) {
     unsigned char* data = nullptr;
 
     if (aiTex->mHeight == 0) {
-        // ѹͼƬpng/jpg
+        // 压缩图片（png/jpg）
         stbi_set_flip_vertically_on_load(false);
         data = stbi_load_from_memory(reinterpret_cast<unsigned char*>(aiTex->pcData), aiTex->mWidth,
             &width, &height, &nrComponents, 0);
@@ -207,6 +234,22 @@ public:
         }
     }
 
+    // 实例化绘制：节点树已在加载时展平，每个 mesh 只发一次 glDrawElementsInstanced，
+    // uniform "model" 为节点变换，每实例的世界矩阵由 setInstanceBuffer 的缓冲提供；返回 draw call 数
+    int DrawInstanced(Shader& shader, int instanceCount) {
+        if (instanceCount <= 0) return 0;
+        for (const auto& d : drawList) {
+            shader.setMat4("model", d.transform);
+            meshes[d.mesh].DrawInstanced(shader, instanceCount);
+        }
+        return (int)drawList.size();
+    }
+
+    // 让所有 mesh 的实例属性都读 instanceVBO（每实例一个 mat4）
+    void setInstanceBuffer(unsigned int instanceVBO) {
+        for (auto& mesh : meshes) mesh.setInstanceBuffer(instanceVBO);
+    }
+
     void DrawCar(Shader& shader, const glm::mat4& baseTransform, Car& car) {
         if (scene && scene->mRootNode) {
             drawNodeCar(scene->mRootNode, shader, baseTransform, car);
@@ -217,7 +260,7 @@ public:
     glm::vec3 getAabbSize()   const { return (aabbMax - aabbMin); }
     float getAabbHeight()     const { return (aabbMax.y - aabbMin.y); }
 
-    // һڡAABB mesh ֲAABB
+    // 归一化：基于【最终AABB】而不是 mesh 局部AABB
     glm::mat4 getNormalizeTransform(bool centerXZ = true, bool liftToGround = true) const {
         glm::mat4 T(1.0f);
         if (!aabbValid) return T;
@@ -240,12 +283,19 @@ public:
     }
 
 private:
+    // 展平后的节点树：每个 (mesh, 节点最终变换) 一项，供实例化绘制
+    struct MeshDraw {
+        unsigned int mesh;
+        glm::mat4 transform;
+    };
+    std::vector<MeshDraw> drawList;
+
     void loadModel(const std::string& path) {
         unsigned int flags =
             aiProcess_Triangulate |
             aiProcess_GenSmoothNormals |
             aiProcess_CalcTangentSpace |
-            aiProcess_FlipUVs; // ԭͿţȲ
+            aiProcess_FlipUVs; // 你原来就开着，先不动
 
         scene = importer.ReadFile(path, flags);
 
@@ -266,8 +316,21 @@ private:
 
         processNode(scene->mRootNode, scene);
 
-        // ؼ meshes ֮ýڵձ任 AABB
+        // 关键：处理完 meshes 之后，用节点树的最终变换来计算 AABB
         computeSceneAABB();
+
+        drawList.clear();
+        flattenNode(scene->mRootNode, glm::mat4(1.0f));
+    }
+
+    void flattenNode(aiNode* node, const glm::mat4& parent) {
+        glm::mat4 global = parent * convertMatrixToGLM(node->mTransformation);
+        for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
+            drawList.push_back({ node->mMeshes[i], global });
+        }
+        for (unsigned int c = 0; c < node->mNumChildren; ++c) {
+            flattenNode(node->mChildren[c], global);
+        }
     }
 
     // ---------- Correct AABB computation (includes node transforms) ----------
@@ -285,7 +348,7 @@ private:
             std::cerr << "[Model] Warning: AABB invalid (no vertices?)" << std::endl;
         }
         else {
-            // ѡ AABB 
+            // 可选：输出 AABB 方便你调试
             // std::cout << "[Model] AABB min=(" << aabbMin.x << "," << aabbMin.y << "," << aabbMin.z << ") "
             //           << "max=(" << aabbMax.x << "," << aabbMax.y << "," << aabbMax.z << ")\n";
         }
@@ -295,7 +358,7 @@ private:
         glm::mat4 nodeT = convertMatrixToGLM(node->mTransformation);
         glm::mat4 global = parent * nodeT;
 
-        // node õ meshҪ global  AABB
+        // node 引用的 mesh，顶点要乘 global 后计入 AABB
         for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
             unsigned int meshIndex = node->mMeshes[i];
             if (meshIndex >= scene->mNumMeshes) continue;
@@ -44,17 +44,17 @@ public:
         const char* vShaderCode = vertexCode.c_str();
         const char* fShaderCode = fragmentCode.c_str();
         unsigned int vertex, fragment;
-        // ɫ
+        // 顶点着色器
         vertex = glCreateShader(GL_VERTEX_SHADER);
         glShaderSource(vertex, 1, &vShaderCode, NULL);
         glCompileShader(vertex);
         checkCompileErrors(vertex, "VERTEX");
-        // Ƭɫ
+        // 片段着色器
         fragment = glCreateShader(GL_FRAGMENT_SHADER);
         glShaderSource(fragment, 1, &fShaderCode, NULL);
         glCompileShader(fragment);
         checkCompileErrors(fragment, "FRAGMENT");
-        // ɫ
+        // 着色器程序
         ID = glCreateProgram();
         glAttachShader(ID, vertex);
         glAttachShader(ID, fragment);
@@ -64,6 +64,31 @@ public:
         glDeleteShader(vertex);
         glDeleteShader(fragment);
     }
+    // 带细分阶段的程序（GL 4.0）：顶点 + 细分控制 + 细分求值 + 片段
+    Shader(const char* vertexPath, const char* tessControlPath, const char* tessEvalPath, const char* fragmentPath)
+    {
+        const char* paths[4] = { vertexPath, tessControlPath, tessEvalPath, fragmentPath };
+        const GLenum types[4] = { GL_VERTEX_SHADER, GL_TESS_CONTROL_SHADER, GL_TESS_EVALUATION_SHADER, GL_FRAGMENT_SHADER };
+        const char* names[4] = { "VERTEX", "TESS_CONTROL", "TESS_EVALUATION", "FRAGMENT" };
+
+        ID = glCreateProgram();
+        unsigned int stages[4];
+        for (int i = 0; i < 4; ++i)
+        {
+            std::cout << "Loading " << names[i] << " shader from: " << paths[i] << std::endl;
+            std::string code = readFile(paths[i]);
+            const char* source = code.c_str();
+            stages[i] = glCreateShader(types[i]);
+            glShaderSource(stages[i], 1, &source, NULL);
+            glCompileShader(stages[i]);
+            checkCompileErrors(stages[i], names[i]);
+            glAttachShader(ID, stages[i]);
+        }
+        glLinkProgram(ID);
+        checkCompileErrors(ID, "PROGRAM");
+
+        for (unsigned int stage : stages) glDeleteShader(stage);
+    }
     void use()
     {
         glUseProgram(ID);
@@ -95,12 +120,37 @@ public:
     //void setMat4(const std::string& name, const glm::mat4& mat) const {
     //    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
     //}
+    void setVec2(const std::string& name, const glm::vec2& value) const {
+        glUniform2fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    }
     void setVec3(const std::string& name, const glm::vec3& value) const {
         glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
     }
+    void setIVec2(const std::string& name, const glm::ivec2& value) const {
+        glUniform2iv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    }
 
 
 private:
+    // 读入整个着色器源文件
+    static std::string readFile(const char* path)
+    {
+        std::ifstream file;
+        file.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+        try
+        {
+            file.open(path);
+            std::stringstream stream;
+            stream << file.rdbuf();
+            return stream.str();
+        }
+        catch (std::ifstream::failure& e)
+        {
+            std::cout << "ERROR::SHADER::FILE_NOT_SUCCESSFULLY_READ: " << e.what() << std::endl;
+        }
+        return std::string();
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
     void checkCompileErrors(unsigned int shader, std::string type)
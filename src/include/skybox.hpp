@@ -39,7 +39,7 @@ public:
         glDepthFunc(GL_LEQUAL);
         shader.use();
 
-        // ȥƽƷ
+        // 去掉平移分量
         glm::mat4 skyboxView = glm::mat4(glm::mat3(view));
         shader.setMat4("view", skyboxView);
         shader.setMat4("projection", projection);
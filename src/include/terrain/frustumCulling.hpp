@@ -2,18 +2,64 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_access.hpp>
 #include <array>
+#include <vector>
 #include <algorithm>
 
+// 批量裁剪的 SIMD 路径：AVX2 一次 8 个盒子，SSE 一次 4 个，否则走标量
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FRUSTUM_SIMD_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_SIMD_SSE 1
+#endif
+
 // ====================== AABB ======================
 struct AABB {
     glm::vec3 min;
     glm::vec3 max;
 };
 
+// ====================== AABBSoA ======================
+// 结构数组（SoA）形式的 AABB 集合：min/max 的 x/y/z 各自连续存放，便于 SIMD 一次读 4/8 个盒子
+struct AABBSoA {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    size_t size() const { return minX.size(); }
+
+    void clear() {
+        minX.clear(); minY.clear(); minZ.clear();
+        maxX.clear(); maxY.clear(); maxZ.clear();
+    }
+
+    void reserve(size_t n) {
+        minX.reserve(n); minY.reserve(n); minZ.reserve(n);
+        maxX.reserve(n); maxY.reserve(n); maxZ.reserve(n);
+    }
+
+    void push_back(const AABB& b) {
+        minX.push_back(b.min.x); minY.push_back(b.min.y); minZ.push_back(b.min.z);
+        maxX.push_back(b.max.x); maxY.push_back(b.max.y); maxZ.push_back(b.max.z);
+    }
+
+    void set(size_t i, const AABB& b) {
+        minX[i] = b.min.x; minY[i] = b.min.y; minZ[i] = b.min.z;
+        maxX[i] = b.max.x; maxY[i] = b.max.y; maxZ[i] = b.max.z;
+    }
+
+    AABB get(size_t i) const {
+        AABB b;
+        b.min = glm::vec3(minX[i], minY[i], minZ[i]);
+        b.max = glm::vec3(maxX[i], maxY[i], maxZ[i]);
+        return b;
+    }
+};
+
 // ====================== Plane ======================
 struct Plane {
     glm::vec3 n;  // normal
-    float d;      // distance: nx + d = 0
+    float d;      // distance: n·x + d = 0
 
     // normalize plane
     void normalize() {
@@ -35,10 +81,10 @@ public:
     // Order: left, right, bottom, top, near, far
     std::array<Plane, 6> planes;
 
-    //  VP ȡ 6 ƽ棨OpenGL clip space Լ
+    // 从 VP 矩阵提取 6 个平面（OpenGL clip space 约定）
     void updateFromMatrix(const glm::mat4& vp) {
-        // glm vp[col][row]
-        // row0..row3
+        // glm 是列主序：vp[col][row]
+        // 行向量：row0..row3
         glm::vec4 row0 = glm::row(vp, 0);
         glm::vec4 row1 = glm::row(vp, 1);
         glm::vec4 row2 = glm::row(vp, 2);
@@ -60,7 +106,7 @@ public:
         for (auto& p : planes) p.normalize();
     }
 
-    // AABB vs Frustum㡱Էҳã
+    // AABB vs Frustum（“积极顶点”测试法，快速且常用）
     bool intersects(const AABB& box) const {
         for (const auto& p : planes) {
             glm::vec3 positive = box.min;
@@ -68,7 +114,7 @@ public:
             if (p.n.y >= 0) positive.y = box.max.y;
             if (p.n.z >= 0) positive.z = box.max.z;
 
-            // 㶼ƽ࣬ AABB 
+            // 若积极顶点都在平面外侧，则整个 AABB 在外侧
             if (p.distance(positive) < 0.0f) {
                 return false;
             }
@@ -76,9 +122,161 @@ public:
         return true;
     }
 
+    // 批量 AABB vs Frustum：把 boxes[begin, end) 中与视锥相交的下标按升序追加到 out。
+    // 判定规则与 intersects 完全一致（正顶点在任一平面外侧即剔除）。
+    void intersectsBatch(const AABBSoA& boxes, size_t begin, size_t end, std::vector<int>& out) const;
+
+    void intersectsBatch(const AABBSoA& boxes, std::vector<int>& out) const {
+        intersectsBatch(boxes, 0, boxes.size(), out);
+    }
+
+    // AABB 与视锥的三态关系（层次裁剪用）
+    enum class Containment { Outside, Intersect, Inside };
+
+    // planeMask：第 i 位为 1 表示仍需测试第 i 个平面。
+    // 父节点已完全位于某平面内侧时，子节点不必再测该平面；返回后 planeMask 只保留仍跨越的平面。
+    Containment classify(const AABB& box, unsigned& planeMask) const {
+        Containment result = Containment::Inside;
+
+        for (int i = 0; i < 6; ++i) {
+            unsigned bit = 1u << i;
+            if (!(planeMask & bit)) continue;
+
+            const Plane& p = planes[i];
+
+            // positive 顶点：沿法线最远；negative 顶点：沿法线最近
+            glm::vec3 positive = box.min;
+            glm::vec3 negative = box.max;
+            if (p.n.x >= 0) { positive.x = box.max.x; negative.x = box.min.x; }
+            if (p.n.y >= 0) { positive.y = box.max.y; negative.y = box.min.y; }
+            if (p.n.z >= 0) { positive.z = box.max.z; negative.z = box.min.z; }
+
+            // 最远点都在外侧 → 整个盒子在外
+            if (p.distance(positive) < 0.0f) {
+                return Containment::Outside;
+            }
+
+            // 最近点也在内侧 → 该平面对子节点不再有意义
+            if (p.distance(negative) >= 0.0f) {
+                planeMask &= ~bit;
+            }
+            else {
+                result = Containment::Intersect;
+            }
+        }
+        return result;
+    }
+
 private:
     void setPlane(int idx, const glm::vec4& eq) {
         planes[idx].n = glm::vec3(eq.x, eq.y, eq.z);
         planes[idx].d = eq.w;
     }
+
+    // 单个 SoA 盒子的标量测试（SIMD 尾部与无 SIMD 平台使用）
+    bool intersectsSoA(const AABBSoA& boxes, size_t i) const {
+        for (const auto& p : planes) {
+            float px = (p.n.x >= 0) ? boxes.maxX[i] : boxes.minX[i];
+            float py = (p.n.y >= 0) ? boxes.maxY[i] : boxes.minY[i];
+            float pz = (p.n.z >= 0) ? boxes.maxZ[i] : boxes.minZ[i];
+            if (p.n.x * px + p.n.y * py + p.n.z * pz + p.d < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
 };
+
+// --------------------------- 批量裁剪实现 ---------------------------
+
+// 把 movemask 中为 1 的 lane 转成下标追加到 out
+static inline void appendMaskedIndices(int mask, size_t base, std::vector<int>& out) {
+    while (mask) {
+        int lane = 0;
+        while (!(mask & (1 << lane))) ++lane;
+        out.push_back((int)(base + lane));
+        mask &= mask - 1;
+    }
+}
+
+inline void Frustum::intersectsBatch(const AABBSoA& boxes, size_t begin, size_t end, std::vector<int>& out) const {
+    end = std::min(end, boxes.size());
+    size_t i = begin;
+
+#if defined(FRUSTUM_SIMD_AVX2) || defined(FRUSTUM_SIMD_SSE)
+    // 每个平面的正顶点分量来自 min 还是 max 只取决于法线符号，与盒子无关，可提前选好数组
+    const float* px[6];
+    const float* py[6];
+    const float* pz[6];
+    for (int k = 0; k < 6; ++k) {
+        const Plane& p = planes[k];
+        px[k] = (p.n.x >= 0 ? boxes.maxX : boxes.minX).data();
+        py[k] = (p.n.y >= 0 ? boxes.maxY : boxes.minY).data();
+        pz[k] = (p.n.z >= 0 ? boxes.maxZ : boxes.minZ).data();
+    }
+#endif
+
+#if defined(FRUSTUM_SIMD_AVX2)
+    __m256 nx[6], ny[6], nz[6], nd[6];
+    for (int k = 0; k < 6; ++k) {
+        nx[k] = _mm256_set1_ps(planes[k].n.x);
+        ny[k] = _mm256_set1_ps(planes[k].n.y);
+        nz[k] = _mm256_set1_ps(planes[k].n.z);
+        nd[k] = _mm256_set1_ps(planes[k].d);
+    }
+    const __m256 zero = _mm256_setzero_ps();
+
+    for (; i + 8 <= end; i += 8) {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (int k = 0; k < 6; ++k) {
+            __m256 dist = _mm256_add_ps(
+                _mm256_add_ps(
+                    _mm256_add_ps(
+                        _mm256_mul_ps(nx[k], _mm256_loadu_ps(px[k] + i)),
+                        _mm256_mul_ps(ny[k], _mm256_loadu_ps(py[k] + i))),
+                    _mm256_mul_ps(nz[k], _mm256_loadu_ps(pz[k] + i))),
+                nd[k]);
+
+            // !(dist < 0)，与标量判定对 NaN 的处理一致
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(dist, zero, _CMP_NLT_UQ));
+            if (_mm256_movemask_ps(inside) == 0) break; // 8 个全被剔除，提前结束
+        }
+
+        appendMaskedIndices(_mm256_movemask_ps(inside), i, out);
+    }
+#elif defined(FRUSTUM_SIMD_SSE)
+    __m128 nx[6], ny[6], nz[6], nd[6];
+    for (int k = 0; k < 6; ++k) {
+        nx[k] = _mm_set1_ps(planes[k].n.x);
+        ny[k] = _mm_set1_ps(planes[k].n.y);
+        nz[k] = _mm_set1_ps(planes[k].n.z);
+        nd[k] = _mm_set1_ps(planes[k].d);
+    }
+    const __m128 zero = _mm_setzero_ps();
+
+    for (; i + 4 <= end; i += 4) {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (int k = 0; k < 6; ++k) {
+            __m128 dist = _mm_add_ps(
+                _mm_add_ps(
+                    _mm_add_ps(
+                        _mm_mul_ps(nx[k], _mm_loadu_ps(px[k] + i)),
+                        _mm_mul_ps(ny[k], _mm_loadu_ps(py[k] + i))),
+                    _mm_mul_ps(nz[k], _mm_loadu_ps(pz[k] + i))),
+                nd[k]);
+
+            inside = _mm_and_ps(inside, _mm_cmpnlt_ps(dist, zero));
+            if (_mm_movemask_ps(inside) == 0) break;
+        }
+
+        appendMaskedIndices(_mm_movemask_ps(inside), i, out);
+    }
+#endif
+
+    // 尾部（或无 SIMD 平台）走标量
+    for (; i < end; ++i) {
+        if (intersectsSoA(boxes, i)) out.push_back((int)i);
+    }
+}
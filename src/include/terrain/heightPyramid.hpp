@@ -0,0 +1,219 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "../threadPool.hpp"
+
+// ====================== HeightPyramid ======================
+// 高度图上的 min/max mip 金字塔（16 位原始采样）。
+// 第 k 层节点 (i, j) 覆盖采样 x ∈ [i*B*2^k, (i+1)*B*2^k]、z 同理（含右 / 下边界，B = 1 << BASE_SHIFT），
+// 因此相邻节点共享边界采样，任意矩形只需取 ≤ 2x2 个节点即可得到保守的 min/max。
+// 底层从 BxB 单元开始以控制内存（2049x2049 约 1.4 MB），更小的矩形直接扫描原始采样。
+// ===========================================================
+class HeightPyramid {
+public:
+    struct MinMax {
+        uint16_t min;
+        uint16_t max;
+    };
+
+    static constexpr int BASE_SHIFT = 2;
+
+    // 由采样构建；samples 指向 (0, 0)，stride 为行跨度（元素）
+    void build(const uint16_t* samples, int stride, int width, int height);
+
+    // 采样矩形 [x0, x1] x [z0, z1] 被修改后，只重算覆盖它的底层节点及其祖先；samples 可换成新的存储（布局不变）
+    void update(const uint16_t* samples, int x0, int z0, int x1, int z1);
+
+    bool empty() const { return levels.empty(); }
+    int levelCount() const { return (int)levels.size(); }
+
+    // 采样矩形 [x0, x1] x [z0, z1]（闭区间，自动裁剪到高度图内）的保守 min/max 原始采样
+    MinMax query(int x0, int z0, int x1, int z1) const;
+
+    // 第 level 层节点 (i, j)（越界返回空区间 {65535, 0}）
+    MinMax node(int level, int i, int j) const;
+    int levelWidth(int level) const { return levels[level].countX; }
+    int levelHeight(int level) const { return levels[level].countZ; }
+    // 第 level 层节点覆盖的单元数（每边）
+    static int nodeCells(int level) { return 1 << (BASE_SHIFT + level); }
+
+    // 占用字节数
+    size_t memoryBytes() const;
+
+private:
+    struct Level {
+        int countX = 0;
+        int countZ = 0;
+        std::vector<MinMax> nodes;
+    };
+
+    MinMax scan(int x0, int z0, int x1, int z1) const;
+    // 合并 child 层中 (i, j) 的 2x2 子节点
+    static MinMax merge(const Level& child, int i, int j);
+
+private:
+    const uint16_t* samples = nullptr;
+    int stride = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<Level> levels;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void HeightPyramid::build(const uint16_t* inSamples, int inStride, int inWidth, int inHeight) {
+    samples = inSamples;
+    stride = inStride;
+    width = inWidth;
+    height = inHeight;
+    levels.clear();
+    if (width < 2 || height < 2) return;
+
+    ThreadPool& pool = ThreadPool::shared();
+    const int B = 1 << BASE_SHIFT;
+    const int cellsX = width - 1;
+    const int cellsZ = height - 1;
+
+    // 底层：直接扫描每个 BxB 单元块的 (B+1)x(B+1) 个采样
+    Level base;
+    base.countX = (cellsX + B - 1) / B;
+    base.countZ = (cellsZ + B - 1) / B;
+    base.nodes.resize((size_t)base.countX * base.countZ);
+    pool.parallelFor(0, base.countZ, [&](int j) {
+        for (int i = 0; i < base.countX; ++i) {
+            base.nodes[(size_t)j * base.countX + i] = scan(i * B, j * B, (i + 1) * B, (j + 1) * B);
+        }
+    }, 8);
+    levels.push_back(std::move(base));
+
+    // 上层：合并 2x2 子节点，直到只剩一个根
+    while (levels.back().countX > 1 || levels.back().countZ > 1) {
+        const Level& child = levels.back();
+        Level parent;
+        parent.countX = (child.countX + 1) / 2;
+        parent.countZ = (child.countZ + 1) / 2;
+        parent.nodes.resize((size_t)parent.countX * parent.countZ);
+
+        pool.parallelFor(0, parent.countZ, [&](int j) {
+            for (int i = 0; i < parent.countX; ++i) {
+                parent.nodes[(size_t)j * parent.countX + i] = merge(child, i, j);
+            }
+        }, 16);
+
+        levels.push_back(std::move(parent));
+    }
+}
+
+inline void HeightPyramid::update(const uint16_t* inSamples, int x0, int z0, int x1, int z1) {
+    samples = inSamples;
+    if (levels.empty()) return;
+
+    const int B = 1 << BASE_SHIFT;
+    x0 = std::max(x0, 0); z0 = std::max(z0, 0);
+    x1 = std::min(x1, width - 1); z1 = std::min(z1, height - 1);
+    if (x0 > x1 || z0 > z1) return;
+
+    // 底层：节点 i 覆盖采样 [i*B, (i+1)*B]，边界采样同时属于左右两个节点
+    Level& base = levels[0];
+    int i0 = std::max((x0 - 1) >> BASE_SHIFT, 0), i1 = std::min(x1 >> BASE_SHIFT, base.countX - 1);
+    int j0 = std::max((z0 - 1) >> BASE_SHIFT, 0), j1 = std::min(z1 >> BASE_SHIFT, base.countZ - 1);
+    for (int j = j0; j <= j1; ++j) {
+        for (int i = i0; i <= i1; ++i) {
+            base.nodes[(size_t)j * base.countX + i] = scan(i * B, j * B, (i + 1) * B, (j + 1) * B);
+        }
+    }
+
+    // 上层：节点区间逐层减半，只重新合并受影响的父节点
+    for (size_t l = 1; l < levels.size(); ++l) {
+        i0 >>= 1; i1 >>= 1;
+        j0 >>= 1; j1 >>= 1;
+        const Level& child = levels[l - 1];
+        Level& parent = levels[l];
+        for (int j = j0; j <= j1; ++j) {
+            for (int i = i0; i <= i1; ++i) {
+                parent.nodes[(size_t)j * parent.countX + i] = merge(child, i, j);
+            }
+        }
+    }
+}
+
+inline HeightPyramid::MinMax HeightPyramid::merge(const Level& child, int i, int j) {
+    MinMax m = { 65535, 0 };
+    for (int dj = 0; dj < 2; ++dj) {
+        int cj = j * 2 + dj;
+        if (cj >= child.countZ) break;
+        for (int di = 0; di < 2; ++di) {
+            int ci = i * 2 + di;
+            if (ci >= child.countX) break;
+            const MinMax& c = child.nodes[(size_t)cj * child.countX + ci];
+            m.min = std::min(m.min, c.min);
+            m.max = std::max(m.max, c.max);
+        }
+    }
+    return m;
+}
+
+inline HeightPyramid::MinMax HeightPyramid::scan(int x0, int z0, int x1, int z1) const {
+    x0 = std::max(x0, 0); z0 = std::max(z0, 0);
+    x1 = std::min(x1, width - 1); z1 = std::min(z1, height - 1);
+
+    MinMax m = { 65535, 0 };
+    for (int z = z0; z <= z1; ++z) {
+        const uint16_t* row = samples + (size_t)z * stride;
+        for (int x = x0; x <= x1; ++x) {
+            m.min = std::min(m.min, row[x]);
+            m.max = std::max(m.max, row[x]);
+        }
+    }
+    return m;
+}
+
+inline HeightPyramid::MinMax HeightPyramid::node(int level, int i, int j) const {
+    const Level& l = levels[level];
+    if (i < 0 || j < 0 || i >= l.countX || j >= l.countZ) return { 65535, 0 };
+    return l.nodes[(size_t)j * l.countX + i];
+}
+
+inline HeightPyramid::MinMax HeightPyramid::query(int x0, int z0, int x1, int z1) const {
+    if (x0 > x1) std::swap(x0, x1);
+    if (z0 > z1) std::swap(z0, z1);
+    x0 = std::max(x0, 0); z0 = std::max(z0, 0);
+    x1 = std::min(x1, width - 1); z1 = std::min(z1, height - 1);
+    if (x0 > x1 || z0 > z1 || levels.empty()) return { 65535, 0 };
+
+    const int B = 1 << BASE_SHIFT;
+
+    // 小矩形：直接扫描，结果精确
+    if ((x1 - x0 + 1) * (z1 - z0 + 1) <= (B + 1) * (B + 1) * 4) return scan(x0, z0, x1, z1);
+
+    // 采样矩形 -> 底层单元区间（单列 / 单行时向左 / 上借一格，仍然保守）
+    int cx0 = std::min(x0, width - 2), cx1 = std::max(cx0, x1 - 1);
+    int cz0 = std::min(z0, height - 2), cz1 = std::max(cz0, z1 - 1);
+    cx0 >>= BASE_SHIFT; cx1 >>= BASE_SHIFT;
+    cz0 >>= BASE_SHIFT; cz1 >>= BASE_SHIFT;
+
+    // 升到两个方向都只跨 ≤ 2 个节点的层
+    int level = 0;
+    while (level + 1 < (int)levels.size() && (cx1 - cx0 > 1 || cz1 - cz0 > 1)) {
+        cx0 >>= 1; cx1 >>= 1;
+        cz0 >>= 1; cz1 >>= 1;
+        ++level;
+    }
+
+    MinMax m = { 65535, 0 };
+    for (int j = cz0; j <= cz1; ++j) {
+        for (int i = cx0; i <= cx1; ++i) {
+            MinMax n = node(level, i, j);
+            m.min = std::min(m.min, n.min);
+            m.max = std::max(m.max, n.max);
+        }
+    }
+    return m;
+}
+
+inline size_t HeightPyramid::memoryBytes() const {
+    size_t bytes = 0;
+    for (const Level& l : levels) bytes += l.nodes.size() * sizeof(MinMax);
+    return bytes;
+}
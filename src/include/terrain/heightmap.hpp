@@ -2,8 +2,40 @@
 #pragma once
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
 #include <glm/glm.hpp>
+#include "../mappedFile.hpp"
+#include "heightPyramid.hpp"
 
+// ====================== 烘焙高度图缓存（.hmc） ======================
+// 第一次加载 PNG 后写出 <png>.hmc：32 字节头 + (width+2)*(height+2) 个小端 uint16 采样
+// （与内存布局相同，含一圈边缘填充）。
+// 之后的启动直接 mmap 该文件，跳过 PNG / zlib 解码；源 PNG 内容变化（哈希不符）时自动重建。
+// ====================================================================
+struct HeightmapCacheHeader {
+    char magic[4];          // "OGHM"
+    uint32_t version;
+    int32_t width;
+    int32_t height;
+    float heightScale;
+    uint32_t reserved;
+    uint64_t sourceHash;    // 源 PNG 文件内容的哈希
+};
+static_assert(sizeof(HeightmapCacheHeader) == 32, "HeightmapCacheHeader must stay 32 bytes");
+
+static constexpr uint32_t HEIGHTMAP_CACHE_VERSION = 2;
+
+// ====================== Heightmap ======================
+// 直接保存源图的 16 位采样（高度 = 采样 * heightScale / 65535），内存只有 float 的一半。
+// 四周各多存一圈复制的边缘采样（行跨度 width + 2），因此 x ∈ [-1, width]、z ∈ [-1, height]
+// 的访问无需 clamp —— 中央差分法线与双线性插值的邻居都落在这个范围内。
+// 来自缓存时采样区直接指向映射内存，不做拷贝。
+// =======================================================
 class Heightmap {
 public:
     int width = 0;
@@ -11,46 +43,302 @@ public:
     int channels = 0;
     float heightScale = 1.0f;
 
-    std::vector<float> heightData;
-
     Heightmap(const std::string& path, float heightScale)
         : heightScale(heightScale)
     {
         load(path);
+        buildPyramid();
     }
 
+    // 世界高度；x ∈ [-1, width]，z ∈ [-1, height]
     float get(int x, int z) const {
-        x = glm::clamp(x, 0, width - 1);
-        z = glm::clamp(z, 0, height - 1);
-        return heightData[z * width + x] * heightScale;
+        return getRaw(x, z) * sampleToHeight();
+    }
+
+    // 取 16 位原始采样（0~65535，对应 0~heightScale），供压缩顶点使用
+    unsigned short getRaw(int x, int z) const {
+        return samples[(size_t)(z + 1) * stride + (x + 1)];
     }
 
+    // 第 z 行（x = 0 处）的采样指针；ptr[-1] 与 ptr[width] 为边缘填充
+    const unsigned short* row(int z) const {
+        return samples + (size_t)(z + 1) * stride + 1;
+    }
+
+    // 行跨度（元素，含两侧填充 = width + 2），row(z + 1) == row(z) + rowStride()
+    int rowStride() const { return stride; }
+
+    // 采样 -> 世界高度的比例，热循环中先插值采样再统一乘
+    float sampleToHeight() const { return heightScale / 65535.0f; }
+
+    // 采样区占用字节数（含填充）
+    size_t memoryBytes() const { return (size_t)stride * (height + 2) * sizeof(unsigned short); }
+
+    // ---------- min/max 金字塔查询（加载时构建一次） ----------
+    // 采样矩形 [x0, x1] x [z0, z1] 内的保守 min/max 原始采样（闭区间，自动裁剪）
+    HeightPyramid::MinMax getRangeRaw(int x0, int z0, int x1, int z1) const {
+        return pyramid.query(x0, z0, x1, z1);
+    }
+    // 同上，换算为世界高度
+    float getMinHeight(int x0, int z0, int x1, int z1) const { return getRangeRaw(x0, z0, x1, z1).min * sampleToHeight(); }
+    float getMaxHeight(int x0, int z0, int x1, int z1) const { return getRangeRaw(x0, z0, x1, z1).max * sampleToHeight(); }
+
+    const HeightPyramid& getPyramid() const { return pyramid; }
+
+    // ---------- 运行时编辑 ----------
+    // 逐个改写采样矩形 [x0, x1] x [z0, z1]（闭区间，自动裁剪）：fn(x, z, raw) 返回新的原始采样。
+    // 第一次编辑时把映射的缓存拷入自有内存（磁盘上的 .hmc 不变）；随后同步边缘填充与金字塔。
+    // 返回是否有采样落在高度图内（x0..z1 被裁剪为实际范围）
+    template <typename Fn>
+    bool modify(int& x0, int& z0, int& x1, int& z1, Fn&& fn);
+
 private:
     void load(const std::string& path);
+    void buildPyramid();
+
+    // PNG 解码路径（慢）；成功后 samples 为 width*height 个 16 位采样
+    bool loadPNG(const std::string& path, std::vector<unsigned short>& samples);
+    // 缓存路径：校验头与源哈希，通过则采样区直接指向映射内存
+    bool loadCache(const std::string& cachePath, uint64_t sourceHash);
+    void writeCache(const std::string& cachePath, uint64_t sourceHash) const;
+
+    // 把 width*height 的紧凑采样拷入带边缘填充的 ownedSamples
+    void assignSamples(const unsigned short* source);
+    // 采样区仍指向映射内存时拷入 ownedSamples 并解除映射，之后可以原地改写
+    void detachFromCache();
+
+    // 源文件内容哈希（按 8 字节字做 FNV-1a）
+    static bool hashFile(const std::string& path, uint64_t& hash);
+    static bool isLittleEndian();
+
+private:
+    const unsigned short* samples = nullptr;    // 指向 ownedSamples 或 cacheFile 的采样区
+    int stride = 0;                             // 行跨度 = width + 2
+    std::vector<unsigned short> ownedSamples;   // PNG 路径：自己持有
+    MappedFile cacheFile;                       // 缓存路径：保持映射
+
+    HeightPyramid pyramid;
 };
 
 void Heightmap::load(const std::string& path) {
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+
+    const std::string cachePath = path + ".hmc";
+
+    // 缓存按小端存储；大端平台直接走 PNG
+    uint64_t sourceHash = 0;
+    bool cacheUsable = isLittleEndian() && hashFile(path, sourceHash);
+
+    if (cacheUsable && loadCache(cachePath, sourceHash)) {
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::cout << "[Heightmap] " << width << "x" << height << " mapped from cache "
+            << cachePath << " in " << ms << " ms (" << (memoryBytes() >> 10) << " KB)" << std::endl;
+        return;
+    }
+
+    std::vector<unsigned short> source;
+    bool decoded = loadPNG(path, source);
+    if (!decoded) {
+        // 保证查询不越界：退化为 1x1 的零高度
+        width = height = 1;
+        source.assign(1, 0);
+    }
+    assignSamples(source.data());
+
+    if (decoded && cacheUsable) writeCache(cachePath, sourceHash);
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "[Heightmap] " << width << "x" << height << " decoded from "
+        << path << " in " << ms << " ms (" << (memoryBytes() >> 10) << " KB)" << std::endl;
+}
+
+void Heightmap::buildPyramid() {
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+
+    pyramid.build(row(0), stride, width, height);
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "[Heightmap] Built min/max pyramid (" << pyramid.levelCount() << " levels, "
+        << (pyramid.memoryBytes() >> 10) << " KB) in " << ms << " ms" << std::endl;
+}
+
+bool Heightmap::loadPNG(const std::string& path, std::vector<unsigned short>& samples) {
     unsigned short* data = stbi_load_16(
         path.c_str(),
         &width,
         &height,
         &channels,
-        1   // ǿƵͨ
+        1   // 强制单通道
     );
 
     if (!data) {
         std::cerr << "Failed to load heightmap: " << path << std::endl;
-        return;
+        return false;
     }
 
-    heightData.resize(width * height);
+    samples.assign(data, data + (size_t)width * height);
+
+    stbi_image_free(data);
+    return true;
+}
+
+bool Heightmap::loadCache(const std::string& cachePath, uint64_t sourceHash) {
+    MappedFile& file = cacheFile;
+    if (!file.open(cachePath)) return false;
 
+    // 任何校验失败都要解除映射：否则缓存文件无法被 writeCache 覆盖，且 isOpen() 会误导 detachFromCache
+    auto fail = [&file] {
+        file.close();
+        return false;
+    };
+    if (file.size() < sizeof(HeightmapCacheHeader)) return fail();
+
+    HeightmapCacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, "OGHM", 4) != 0 ||
+        header.version != HEIGHTMAP_CACHE_VERSION ||
+        header.sourceHash != sourceHash ||
+        header.heightScale != heightScale ||
+        header.width <= 0 || header.height <= 0)
+    {
+        return fail();
+    }
+
+    size_t sampleBytes = (size_t)(header.width + 2) * (header.height + 2) * sizeof(unsigned short);
+    if (file.size() != sizeof(header) + sampleBytes) return fail();
+
+    width = header.width;
+    height = header.height;
+    channels = 1;
+    stride = width + 2;
+
+    // 头为 32 字节，采样区天然 2 字节对齐；直接使用映射内存
+    samples = (const unsigned short*)(file.data() + sizeof(header));
+    return true;
+}
+
+void Heightmap::writeCache(const std::string& cachePath, uint64_t sourceHash) const {
+    HeightmapCacheHeader header = {};
+    std::memcpy(header.magic, "OGHM", 4);
+    header.version = HEIGHTMAP_CACHE_VERSION;
+    header.width = width;
+    header.height = height;
+    header.heightScale = heightScale;
+    header.sourceHash = sourceHash;
+
+    // 先写临时文件再改名，避免中途退出留下半个缓存
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "Heightmap: cannot write cache " << tmpPath << std::endl;
+            return;
+        }
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)samples, memoryBytes());
+        if (!out) {
+            std::cerr << "Heightmap: failed writing cache " << tmpPath << std::endl;
+            out.close();
+            std::remove(tmpPath.c_str());
+            return;
+        }
+    }
+
+    std::remove(cachePath.c_str()); // Windows 下 rename 不会覆盖已有文件
+    if (std::rename(tmpPath.c_str(), cachePath.c_str()) != 0) {
+        std::cerr << "Heightmap: cannot rename cache to " << cachePath << std::endl;
+        std::remove(tmpPath.c_str());
+    }
+}
+
+void Heightmap::assignSamples(const unsigned short* source) {
+    stride = width + 2;
+    ownedSamples.resize((size_t)stride * (height + 2));
+
+    // 内部行：左右各复制一个边缘采样
     for (int z = 0; z < height; ++z) {
-        for (int x = 0; x < width; ++x) {
-            int index = z * width + x;
-            heightData[index] = data[index] / 65535.0f;
+        const unsigned short* src = source + (size_t)z * width;
+        unsigned short* dst = &ownedSamples[(size_t)(z + 1) * stride];
+        dst[0] = src[0];
+        std::memcpy(dst + 1, src, width * sizeof(unsigned short));
+        dst[width + 1] = src[width - 1];
+    }
+
+    // 上下各复制一整行（含角）
+    std::memcpy(&ownedSamples[0], &ownedSamples[stride], stride * sizeof(unsigned short));
+    std::memcpy(&ownedSamples[(size_t)(height + 1) * stride], &ownedSamples[(size_t)height * stride], stride * sizeof(unsigned short));
+
+    samples = ownedSamples.data();
+}
+
+template <typename Fn>
+bool Heightmap::modify(int& x0, int& z0, int& x1, int& z1, Fn&& fn) {
+    if (x0 > x1) std::swap(x0, x1);
+    if (z0 > z1) std::swap(z0, z1);
+    x0 = std::max(x0, 0); z0 = std::max(z0, 0);
+    x1 = std::min(x1, width - 1); z1 = std::min(z1, height - 1);
+    if (x0 > x1 || z0 > z1) return false;
+
+    detachFromCache();
+
+    for (int z = z0; z <= z1; ++z) {
+        unsigned short* dst = &ownedSamples[(size_t)(z + 1) * stride + 1];
+        for (int x = x0; x <= x1; ++x) {
+            dst[x] = fn(x, z, dst[x]);
         }
+        // 左右填充列跟随边缘采样
+        if (x0 == 0) dst[-1] = dst[0];
+        if (x1 == width - 1) dst[width] = dst[width - 1];
     }
 
-    stbi_image_free(data);
+    // 上下填充行（含角）跟随第一 / 最后一行
+    if (z0 == 0) std::memcpy(&ownedSamples[0], &ownedSamples[stride], stride * sizeof(unsigned short));
+    if (z1 == height - 1) {
+        std::memcpy(&ownedSamples[(size_t)(height + 1) * stride], &ownedSamples[(size_t)height * stride],
+            stride * sizeof(unsigned short));
+    }
+
+    pyramid.update(row(0), x0, z0, x1, z1);
+    return true;
+}
+
+void Heightmap::detachFromCache() {
+    if (!cacheFile.isOpen()) return;
+
+    ownedSamples.assign(samples, samples + (size_t)stride * (height + 2));
+    samples = ownedSamples.data();
+    cacheFile.close();
+    pyramid.update(row(0), 0, 0, -1, -1); // 只换采样指针
+}
+
+bool Heightmap::hashFile(const std::string& path, uint64_t& hash) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    const uint64_t prime = 1099511628211ull;
+    hash = 14695981039346656037ull;
+
+    const unsigned char* p = file.data();
+    size_t n = file.size();
+    size_t words = n / 8;
+    for (size_t i = 0; i < words; ++i) {
+        uint64_t w;
+        std::memcpy(&w, p + i * 8, 8);
+        hash = (hash ^ w) * prime;
+    }
+    for (size_t i = words * 8; i < n; ++i) {
+        hash = (hash ^ p[i]) * prime;
+    }
+    hash ^= (uint64_t)n;
+    return true;
+}
+
+bool Heightmap::isLittleEndian() {
+    const uint16_t one = 1;
+    unsigned char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include <string>
+#include <memory>
 #include "../shader.hpp"
 #include "terrainSystem.hpp"
+#include "terrainClipmap.hpp"
 
-// ԭȵ loadTexture2D Լ data==nullptr ıﰴз񲻸ģ
+// 你原先的 loadTexture2D 保留（建议你自己额外加 data==nullptr 的保护，这里按你现有风格不改）
 unsigned int loadTexture2D(const std::string& path)
 {
     unsigned int texID;
@@ -35,61 +37,107 @@ public:
     Terrain(
         const std::string& heightmapPath,
         float heightScale,
-        int chunkCountX, int chunkCountZ, int chunkSize, float gridScale
+        int chunkCountX, int chunkCountZ, int chunkSize, float gridScale,
+        TerrainRenderMode mode = TerrainRenderMode::MultiDraw,
+        const TerrainPagerSettings& paging = TerrainPagerSettings(),
+        const TerrainClipmapSettings& clipmapSettings = TerrainClipmapSettings()
     );
 
     ~Terrain();
 
     void setLODDistances(float d0, float d1, float d2);
+    void setLODPixelError(float pixels);
+    void setRenderMode(TerrainRenderMode mode);
+    void setSeamMode(TerrainSeamMode mode);
+    void setOcclusionCulling(bool enabled);
+    // 细分模式：细分后每段边的目标像素长度
+    void setTessellationPixels(float pixels);
+    // 上一帧地平线遮挡剔除的 chunk 数
+    const TerrainOcclusionStats& getOcclusionStats() const;
+    // 地形编辑：fn(worldX, worldZ, height) 返回矩形内每个采样的新高度；GPU 数据按当前模式增量更新
+    void modifyHeights(const TerrainRect& rect, const TerrainHeightEdit& fn);
+    // 每帧重建被编辑 chunk 的时间预算（毫秒）
+    void setEditBudget(float ms);
+    // clipmap 模式的渲染器（未切到该模式时未创建）
+    const TerrainClipmap& getClipmap() const { return clipmap; }
     void render(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos);
 
     float getHeightWorld(float worldX, float worldZ) const;
     glm::vec3 getNormalWorld(float worldX, float worldZ) const;
+    // 批量版本：worldX / worldZ 各 count 个点，AVX2 下 8 个一组
+    void getHeightWorldBatch(const float* worldX, const float* worldZ, float* outY, size_t count) const;
+    void getNormalWorldBatch(const float* worldX, const float* worldZ, glm::vec3* outN, size_t count) const;
     float getSlopeRadians(float worldX, float worldZ) const;
     float getSlopeDegrees(float worldX, float worldZ) const;
+    // 世界矩形内地形高度的保守范围（x = min, y = max）
+    glm::vec2 getHeightRangeWorld(float minX, float minZ, float maxX, float maxZ) const;
+    float getMaxHeightWorld(float minX, float minZ, float maxX, float maxZ) const;
+
+    // 射线查询（拾取 / 视线 / 相机遮挡）
+    TerrainRayHit raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const;
+    void raycastBatch(const std::vector<TerrainRay>& rays, std::vector<TerrainRayHit>& hits) const;
 
 private:
     void loadTextures();
-    void setupShader();
+    void setupShader(Shader& shader);
+    void renderClipmap(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos);
+    // 细分模式的着色器程序（GL 4.0），第一次使用时编译
+    Shader& tessellationShader();
 
     Heightmap heightmap;
     TerrainSystem terrainSystem;
     Shader terrainShader;
 
+    // clipmap 模式：同一套材质（terrain.fs），顶点着色器换成 clipmap.vs
+    Shader clipmapShader;
+    TerrainClipmap clipmap;
+    TerrainClipmapSettings clipmapSettings;
+    float gridScale;
+
+    // 细分模式：terrain_tess.vs + terrain.tcs + terrain.tes + terrain.fs
+    std::unique_ptr<Shader> tessShader;
+
     // ---------- Textures ----------
-    unsigned int grassLowTex = 0; // ͺβ
-    unsigned int grassHighTex = 0; // ߺβ(ԭ grass_diff_2)
+    unsigned int grassLowTex = 0; // 低海拔草
+    unsigned int grassHighTex = 0; // 高海拔草(你原来的 grass_diff_2)
     unsigned int noiseTex = 0;
 
     // ---------- Material / Blend Params ----------
     float uvScale = 32.0f;
 
-    // ߶ȿƣͲ -> ߲
-    float grassLowMaxHeight = 1080.0f; // <= ǵͲ
-    float grassHighMinHeight = 1100.0f; // >= Ǹ߲
+    // 高度控制：低草 -> 高草
+    float grassLowMaxHeight = 1080.0f; // <= 基本都是低草
+    float grassHighMinHeight = 1100.0f; // >= 基本都是高草
 
-    // ϴ߶ȵλԽԽԽȻ
-    float blendWidth = 30.0f; //  6~30ݵθ߶ȳ߶ȵ
+    // 混合带宽（世界高度单位）：越大越“糊”越自然
+    float blendWidth = 30.0f; // 建议 6~30，根据地形高度尺度调
 
-    // ڡŶɱ߽硱ùȻ
-    float blendNoiseScale = 0.05f;  // Ƶ
-    float blendNoiseAmp = 0.25f;  // 0~1 0.15~0.5
+    // 噪声参数：用于“扰动过渡边界”，让过渡碎裂自然
+    float blendNoiseScale = 0.05f;  // 低频噪声
+    float blendNoiseAmp = 0.25f;  // 0~1，建议 0.15~0.5
 
-    // ߣ>1 ùɸ/Ȼѡ
+    // 过渡曲线：>1 会让过渡更集中/更自然（可选）
     float blendPower = 1.2f;
 };
 
 inline Terrain::Terrain(
     const std::string& heightmapPath,
     float heightScale,
-    int chunkCountX, int chunkCountZ, int chunkSize, float gridScale
+    int chunkCountX, int chunkCountZ, int chunkSize, float gridScale,
+    TerrainRenderMode mode,
+    const TerrainPagerSettings& paging,
+    const TerrainClipmapSettings& clipmapSettings
 )
     : heightmap(heightmapPath, heightScale),
-    terrainSystem(heightmap, chunkCountX, chunkCountZ, chunkSize, gridScale),
-    terrainShader(SHADERS_FOLDER "terrain.vs", SHADERS_FOLDER "terrain.fs")
+    terrainSystem(heightmap, chunkCountX, chunkCountZ, chunkSize, gridScale, mode, paging),
+    terrainShader(SHADERS_FOLDER "terrain.vs", SHADERS_FOLDER "terrain.fs"),
+    clipmapShader(SHADERS_FOLDER "clipmap.vs", SHADERS_FOLDER "terrain.fs"),
+    clipmapSettings(clipmapSettings),
+    gridScale(gridScale)
 {
     loadTextures();
-    setupShader();
+    setupShader(terrainShader);
+    setupShader(clipmapShader);
 }
 
 inline void Terrain::loadTextures() {
@@ -98,45 +146,100 @@ inline void Terrain::loadTextures() {
     noiseTex = loadTexture2D(ASSETS_FOLDER "terrain/noise.png");
 }
 
-inline void Terrain::setupShader() {
-    terrainShader.use();
+// terrainShader 与 clipmapShader 共用 terrain.fs，材质参数相同（各自不存在的 uniform 会被忽略）
+inline void Terrain::setupShader(Shader& shader) {
+    shader.use();
 
     // sampler2D bindings
-    terrainShader.setInt("grassLowTex", 0);
-    terrainShader.setInt("grassHighTex", 1);
-    terrainShader.setInt("noiseTex", 2);
+    shader.setInt("grassLowTex", 0);
+    shader.setInt("grassHighTex", 1);
+    shader.setInt("noiseTex", 2);
+
+    // isamplerBuffer：分页模式的槽位 -> chunk 查找表
+    shader.setInt("uSlotChunks", TERRAIN_SLOT_TEXTURE_UNIT);
+
+    // 实例化（VTF）模式的高度 / 法线纹理
+    shader.setInt("uHeightTex", TERRAIN_HEIGHT_TEXTURE_UNIT);
+    shader.setInt("uNormalTex", TERRAIN_NORMAL_TEXTURE_UNIT);
+
+    // clipmap 模式的环形高度纹理数组
+    shader.setInt("uClipHeights", TERRAIN_CLIPMAP_TEXTURE_UNIT);
 
     // base tiling
-    terrainShader.setFloat("uvScale", uvScale);
+    shader.setFloat("uvScale", uvScale);
 
     // height thresholds
-    terrainShader.setFloat("grassLowMaxHeight", grassLowMaxHeight);
-    terrainShader.setFloat("grassHighMinHeight", grassHighMinHeight);
+    shader.setFloat("grassLowMaxHeight", grassLowMaxHeight);
+    shader.setFloat("grassHighMinHeight", grassHighMinHeight);
 
     // better blend controls
-    terrainShader.setFloat("blendWidth", blendWidth);
-    terrainShader.setFloat("blendNoiseScale", blendNoiseScale);
-    terrainShader.setFloat("blendNoiseAmp", blendNoiseAmp);
-    terrainShader.setFloat("blendPower", blendPower);
+    shader.setFloat("blendWidth", blendWidth);
+    shader.setFloat("blendNoiseScale", blendNoiseScale);
+    shader.setFloat("blendNoiseAmp", blendNoiseAmp);
+    shader.setFloat("blendPower", blendPower);
 }
 
 inline void Terrain::setLODDistances(float d0, float d1, float d2) {
     terrainSystem.setLODDistances(d0, d1, d2);
 }
 
+inline void Terrain::setLODPixelError(float pixels) {
+    terrainSystem.setLODPixelError(pixels);
+}
+
+inline void Terrain::setRenderMode(TerrainRenderMode mode) {
+    terrainSystem.setRenderMode(mode);
+}
+
+inline void Terrain::setSeamMode(TerrainSeamMode mode) {
+    terrainSystem.setSeamMode(mode);
+}
+
+inline void Terrain::setOcclusionCulling(bool enabled) {
+    terrainSystem.setOcclusionCulling(enabled);
+}
+
+inline void Terrain::setTessellationPixels(float pixels) {
+    terrainSystem.setTessellationPixels(pixels);
+}
+
+inline const TerrainOcclusionStats& Terrain::getOcclusionStats() const {
+    return terrainSystem.getOcclusionStats();
+}
+
+inline void Terrain::modifyHeights(const TerrainRect& rect, const TerrainHeightEdit& fn) {
+    TerrainSampleRect r = terrainSystem.modifyHeights(rect, fn);
+    if (r.empty()) return;
+
+    // clipmap 的高度纹理由 Terrain 持有：重传各层窗口中受影响的格点
+    clipmap.refreshRegion(r.x0, r.z0, r.x1, r.z1);
+}
+
+inline void Terrain::setEditBudget(float ms) {
+    terrainSystem.setEditBudget(ms);
+}
+
 inline void Terrain::render(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos) {
-    terrainShader.use();
+    if (terrainSystem.getRenderMode() == TerrainRenderMode::Clipmap) {
+        renderClipmap(view, projection, cameraPos);
+        return;
+    }
+
+    // 细分模式换用带 TCS / TES 的程序，其余流程相同
+    Shader& shader = (terrainSystem.getRenderMode() == TerrainRenderMode::Tessellated)
+        ? tessellationShader() : terrainShader;
+    shader.use();
 
     glm::mat4 model = glm::mat4(1.0f);
-    terrainShader.setMat4("model", model);
-    terrainShader.setMat4("view", view);
-    terrainShader.setMat4("projection", projection);
+    shader.setMat4("model", model);
+    shader.setMat4("view", view);
+    shader.setMat4("projection", projection);
 
     // Directional light (world space)
     glm::vec3 dir = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.4f));
     glm::vec3 color = glm::vec3(1.0f);
-    terrainShader.setVec3("lightDir", dir);
-    terrainShader.setVec3("lightColor", color);
+    shader.setVec3("lightDir", dir);
+    shader.setVec3("lightColor", color);
 
     // Bind textures
     glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, grassLowTex);
@@ -144,7 +247,7 @@ inline void Terrain::render(const glm::mat4& view, const glm::mat4& projection,
     glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, noiseTex);
 
     terrainSystem.Draw(
-        terrainShader,
+        shader,
         model,
         view,
         projection,
@@ -152,6 +255,41 @@ inline void Terrain::render(const glm::mat4& view, const glm::mat4& projection,
     );
 }
 
+inline Shader& Terrain::tessellationShader() {
+    if (!tessShader) {
+        tessShader = std::make_unique<Shader>(
+            SHADERS_FOLDER "terrain_tess.vs",
+            SHADERS_FOLDER "terrain.tcs",
+            SHADERS_FOLDER "terrain.tes",
+            SHADERS_FOLDER "terrain.fs");
+        setupShader(*tessShader);
+    }
+    return *tessShader;
+}
+
+// clipmap 模式：uniform / 纹理与 render 相同，几何由 TerrainClipmap 提供（第一次进入时创建）
+inline void Terrain::renderClipmap(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& cameraPos) {
+    clipmap.build(heightmap, gridScale, clipmapSettings);
+
+    clipmapShader.use();
+
+    glm::mat4 model = glm::mat4(1.0f);
+    clipmapShader.setMat4("model", model);
+    clipmapShader.setMat4("view", view);
+    clipmapShader.setMat4("projection", projection);
+
+    glm::vec3 dir = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.4f));
+    glm::vec3 color = glm::vec3(1.0f);
+    clipmapShader.setVec3("lightDir", dir);
+    clipmapShader.setVec3("lightColor", color);
+
+    glActiveTexture(GL_TEXTURE0); glBindTexture(GL_TEXTURE_2D, grassLowTex);
+    glActiveTexture(GL_TEXTURE1); glBindTexture(GL_TEXTURE_2D, grassHighTex);
+    glActiveTexture(GL_TEXTURE2); glBindTexture(GL_TEXTURE_2D, noiseTex);
+
+    clipmap.render(clipmapShader, projection * view, cameraPos);
+}
+
 inline float Terrain::getHeightWorld(float worldX, float worldZ) const {
     return terrainSystem.getHeightWorld(worldX, worldZ);
 }
@@ -160,6 +298,14 @@ inline glm::vec3 Terrain::getNormalWorld(float worldX, float worldZ) const {
     return terrainSystem.getNormalWorld(worldX, worldZ);
 }
 
+inline void Terrain::getHeightWorldBatch(const float* worldX, const float* worldZ, float* outY, size_t count) const {
+    terrainSystem.getHeightWorldBatch(worldX, worldZ, outY, count);
+}
+
+inline void Terrain::getNormalWorldBatch(const float* worldX, const float* worldZ, glm::vec3* outN, size_t count) const {
+    terrainSystem.getNormalWorldBatch(worldX, worldZ, outN, count);
+}
+
 inline float Terrain::getSlopeRadians(float worldX, float worldZ) const {
     return terrainSystem.getSlopeRadians(worldX, worldZ);
 }
@@ -168,6 +314,22 @@ inline float Terrain::getSlopeDegrees(float worldX, float worldZ) const {
     return terrainSystem.getSlopeDegrees(worldX, worldZ);
 }
 
+inline glm::vec2 Terrain::getHeightRangeWorld(float minX, float minZ, float maxX, float maxZ) const {
+    return terrainSystem.getHeightRangeWorld(minX, minZ, maxX, maxZ);
+}
+
+inline float Terrain::getMaxHeightWorld(float minX, float minZ, float maxX, float maxZ) const {
+    return terrainSystem.getMaxHeightWorld(minX, minZ, maxX, maxZ);
+}
+
+inline TerrainRayHit Terrain::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const {
+    return terrainSystem.raycast(origin, dir, maxDist);
+}
+
+inline void Terrain::raycastBatch(const std::vector<TerrainRay>& rays, std::vector<TerrainRayHit>& hits) const {
+    terrainSystem.raycastBatch(rays, hits);
+}
+
 inline Terrain::~Terrain() {
     glDeleteTextures(1, &grassLowTex);
     glDeleteTextures(1, &grassHighTex);
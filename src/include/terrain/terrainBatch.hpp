@@ -0,0 +1,146 @@
+#pragma once
+#include <vector>
+#include "terrainChunk.hpp"
+#include "terrainIndexBuffer.hpp"
+
+// ====================== TerrainBatch ======================
+// 批量绘制模式：所有 chunk 的顶点放进同一个大 VBO，共用一个 VAO + 共享 EBO。
+// 每帧由裁剪 / LOD 循环填充绘制列表，最后每个 LOD 只发一次
+// glMultiDrawElementsBaseVertex（chunk 之间仅 baseVertex 不同）。
+// ==========================================================
+class TerrainBatch {
+public:
+    TerrainBatch() = default;
+    ~TerrainBatch() { release(); }
+
+    TerrainBatch(const TerrainBatch&) = delete;
+    TerrainBatch& operator=(const TerrainBatch&) = delete;
+
+    // 把所有 chunk 顶点拷入一个大 VBO，并建立共享 VAO
+    void build(const std::vector<TerrainChunk>& chunks, const TerrainIndexBuffer& indices);
+    // 分步上传：先按 chunk 数量分配整块 VBO，再在 chunk 构建完成时逐个写入
+    void allocate(int chunkCount, int vertsPerChunk, const TerrainIndexBuffer& indices);
+    void upload(int chunkIndex, const TerrainChunk& chunk);
+    // 释放 VAO / VBO
+    void release();
+    bool isBuilt() const { return VAO != 0; }
+
+    // 每帧开始时清空绘制列表
+    void begin();
+    // 登记一个可见 chunk（chunkIndex 为 chunks 中的下标），绘制该 LOD 的主体 + skirt
+    void add(int chunkIndex, int lod);
+    // 登记一个可见 chunk，绘制指定索引区间（缝合变体），按 lod 归入绘制列表
+    void add(int chunkIndex, int lod, const TerrainIndexRange& range);
+    // 提交：每个非空 LOD 一次 multi-draw
+    void flush();
+
+private:
+    struct DrawList {
+        std::vector<GLsizei> counts;
+        std::vector<const void*> offsets;
+        std::vector<GLint> baseVertices;
+
+        void clear() {
+            counts.clear();
+            offsets.clear();
+            baseVertices.clear();
+        }
+    };
+
+    DrawList lists[TerrainIndexBuffer::LOD_COUNT];
+
+    const TerrainIndexBuffer* indices = nullptr;
+    int vertsPerChunk = 0;
+
+    unsigned int VAO = 0, VBO = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainBatch::build(const std::vector<TerrainChunk>& chunks, const TerrainIndexBuffer& inIndices) {
+    if (VAO != 0 || chunks.empty()) return;
+
+    allocate((int)chunks.size(), (int)chunks.front().getVertices().size(), inIndices);
+    for (int i = 0; i < (int)chunks.size(); ++i) {
+        upload(i, chunks[i]);
+    }
+}
+
+inline void TerrainBatch::allocate(int chunkCount, int inVertsPerChunk, const TerrainIndexBuffer& inIndices) {
+    if (VAO != 0 || chunkCount <= 0) return;
+
+    indices = &inIndices;
+    vertsPerChunk = inVertsPerChunk;
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+
+    glBindVertexArray(VAO);
+
+    // 先分配整块，之后逐 chunk 写入（chunk i 占据 [i*V, (i+1)*V)）
+    const size_t chunkBytes = (size_t)vertsPerChunk * sizeof(TerrainVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, chunkBytes * chunkCount, nullptr, GL_STATIC_DRAW);
+
+    setupTerrainVertexAttribs();
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices->getEBO());
+
+    glBindVertexArray(0);
+
+    // 绘制列表最多容纳全部 chunk，提前分配避免每帧扩容
+    for (auto& list : lists) {
+        list.counts.reserve(chunkCount);
+        list.offsets.reserve(chunkCount);
+        list.baseVertices.reserve(chunkCount);
+    }
+}
+
+inline void TerrainBatch::upload(int chunkIndex, const TerrainChunk& chunk) {
+    const size_t chunkBytes = (size_t)vertsPerChunk * sizeof(TerrainVertex);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, chunkBytes * chunkIndex, chunkBytes, chunk.getVertices().data());
+}
+
+inline void TerrainBatch::release() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &VBO);
+        VAO = 0;
+        VBO = 0;
+    }
+}
+
+inline void TerrainBatch::begin() {
+    for (auto& list : lists) list.clear();
+}
+
+inline void TerrainBatch::add(int chunkIndex, int lod) {
+    add(chunkIndex, lod, indices->combined(lod));
+}
+
+inline void TerrainBatch::add(int chunkIndex, int lod, const TerrainIndexRange& range) {
+    DrawList& list = lists[TerrainIndexBuffer::clampLOD(lod)];
+    list.counts.push_back((GLsizei)range.count);
+    list.offsets.push_back((const void*)range.offset);
+    list.baseVertices.push_back((GLint)(chunkIndex * vertsPerChunk));
+}
+
+inline void TerrainBatch::flush() {
+    glBindVertexArray(VAO);
+
+    for (auto& list : lists) {
+        if (list.counts.empty()) continue;
+
+        glMultiDrawElementsBaseVertex(
+            GL_TRIANGLES,
+            list.counts.data(),
+            GL_UNSIGNED_SHORT,
+            list.offsets.data(),
+            (GLsizei)list.counts.size(),
+            list.baseVertices.data()
+        );
+    }
+
+    glBindVertexArray(0);
+}
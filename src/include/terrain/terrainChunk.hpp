@@ -1,49 +1,97 @@
 #pragma once
 #include <vector>
 #include <limits>
+#include <cstdint>
+#include <cmath>
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include "../shader.hpp"
 #include "heightmap.hpp"
+#include "terrainNormalField.hpp"
 #include "frustumCulling.hpp" // AABB
+#include "terrainIndexBuffer.hpp"
 
+// Skirt 下拉深度：需要足够盖住 LOD 裂缝（terrain.vs 中同样使用该值）
+static constexpr float TERRAIN_SKIRT_DEPTH = 50.0f;
+
+// 压缩地形顶点（8 字节）：
+// X/Z 与 UV 完全由网格下标 + chunk 原点决定，terrain.vs 用 gl_VertexID 重建，
+// 这里只存 16 位量化高度与八面体编码法线。skirt 顶点是边界顶点的原样副本，下拉在着色器中完成。
 struct TerrainVertex {
-    glm::vec3 Position;
-    glm::vec3 Normal;
-    glm::vec2 TexCoords;
+    uint16_t Height;      // 0~65535 → 0~heightScale
+    int16_t  Normal[2];   // 八面体编码（snorm16），以 +Y 为主轴
+    uint16_t Padding;     // 对齐到 8 字节
 };
 
+// 为当前绑定的 VAO / VBO 设置 TerrainVertex 的顶点属性（单 chunk VAO 与批量 VAO 共用）
+static inline void setupTerrainVertexAttribs() {
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 1, GL_UNSIGNED_SHORT, GL_TRUE,
+        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, Height));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE,
+        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, Normal));
+}
+
 class TerrainChunk {
 public:
     TerrainChunk(
         Heightmap& heightmap,
+        const TerrainNormalField& normals, // TerrainSystem 持有的全分辨率法线场
         int chunkX,
         int chunkZ,
-        int chunkSize,     //  33=2^n+1
-        float gridScale
+        int chunkSize,     // 顶点数，例如 33（=2^n+1）
+        float gridScale,
+        const TerrainIndexBuffer& indices // TerrainSystem 持有的共享索引
     );
 
+    // CPU 侧构建：顶点 / 法线 / skirt / bounds。不触碰 GL，可在工作线程中调用
+    void build();
+
+    // 只生成顶点与 skirt，不写 bounds / LOD 误差（主线程每帧都在读它们）；分页的后台构建与编辑后的重建用
+    void buildGeometry();
+
+    // 只计算 bounds 与各 LOD 几何误差（直接读 heightmap，不生成顶点）；分页模式下用于未驻留 chunk
+    void computeBounds();
+
+    // bounds 计入的 skirt 深度（缝合模式不画 skirt，设为 0 得到更紧的 AABB）；下次 computeBounds / build 生效
+    void setSkirtDepth(float depth) { skirtDepth = depth; }
+
+    // 释放 CPU 顶点（分页模式上传 GPU 后调用，保持内存占用固定）
+    void releaseVertices() { std::vector<TerrainVertex>().swap(vertices); }
+
     void Draw(Shader& shader, int lod);
+    // 绘制共享 EBO 中任意一段索引（缝合变体）
+    void Draw(Shader& shader, const TerrainIndexRange& range);
+
+    // 为本 chunk 创建独立 VAO/VBO（仅逐 chunk 绘制模式需要；批量模式由 TerrainBatch 统一上传）
+    void setupMesh();
+    // 顶点重建后原地覆盖 VBO（顶点数不变，glBufferSubData）
+    void updateMesh();
+    bool hasMesh() const { return VAO != 0; }
+
+    const std::vector<TerrainVertex>& getVertices() const { return vertices; }
 
     AABB TerrainChunk::getAABBWorld() const { return bounds; };
     glm::vec3 getCenter() const { return center; };
 
+    // 该 LOD 相对全分辨率 heightmap 的最大高度误差（世界单位，随 LOD 单调不减）
+    float getLODError(int lod) const { return lodError[TerrainIndexBuffer::clampLOD(lod)]; }
+
 private:
     void buildVertices();
-    void buildIndices(int step, std::vector<unsigned int>& outIndices);
 
-    // Skirt㣨ıߣÿ LOD  skirt 
-    void buildSkirtVertices(float skirtDepth);
-    void buildSkirtIndicesForLOD(int step, std::vector<unsigned int>& out);
-
-    void setupMesh();
-    void computeBounds(float skirtDepth);
+    // Skirt：生成边界顶点副本（四边，下拉在着色器中完成），索引由共享的 TerrainIndexBuffer 提供
+    void buildSkirtVertices();
 
-    glm::vec3 calculateNormal(int hx, int hz) const;
+    // 每个 LOD 的三角形（与 TerrainIndexBuffer 相同的 tr-bl 对角线）与原始采样之间的最大高度差
+    void computeLODErrors();
 
 private:
     Heightmap& heightmap;
+    const TerrainNormalField& normals;
 
     int chunkX, chunkZ;
     int chunkSize;
@@ -51,234 +99,121 @@ private:
 
     std::vector<TerrainVertex> vertices;
 
-    //  indicesLOD0~3
-    std::vector<unsigned int> indicesLOD0;
-    std::vector<unsigned int> indicesLOD1;
-    std::vector<unsigned int> indicesLOD2;
-    std::vector<unsigned int> indicesLOD3;
+    // 共享的 LOD / skirt 索引（所有 chunk 拓扑相同）
+    const TerrainIndexBuffer& indices;
 
-    // Skirt indicesLOD0~3
-    std::vector<unsigned int> skirtIndicesLOD0;
-    std::vector<unsigned int> skirtIndicesLOD1;
-    std::vector<unsigned int> skirtIndicesLOD2;
-    std::vector<unsigned int> skirtIndicesLOD3;
-
-    // OpenGL
+    // OpenGL：chunk 只拥有自己的顶点数据
     unsigned int VAO = 0, VBO = 0;
 
-    unsigned int EBOLOD0 = 0, EBOLOD1 = 0, EBOLOD2 = 0, EBOLOD3 = 0;
-    unsigned int EBOSkirt0 = 0, EBOSkirt1 = 0, EBOSkirt2 = 0, EBOSkirt3 = 0;
-
-    // Skirt ӳ䣺ԭʼ߽綥 index -> Ӧ skirt  index vertices ĩβ
-    std::vector<int> skirtMap; // size = chunkSize*chunkSize, -1 ʾ
-
     AABB bounds;
     glm::vec3 center;
+    float skirtDepth = TERRAIN_SKIRT_DEPTH;
+    float lodError[TerrainIndexBuffer::LOD_COUNT] = {};
 };
 
-// --------------------------- ʵ ---------------------------
-
-static inline bool isBoundary(int x, int z, int N) {
-    return (x == 0 || z == 0 || x == N - 1 || z == N - 1);
-}
+// --------------------------- 实现 ---------------------------
 
 TerrainChunk::TerrainChunk(
     Heightmap& heightmap,
+    const TerrainNormalField& normals,
     int chunkX,
     int chunkZ,
     int chunkSize,
-    float gridScale
+    float gridScale,
+    const TerrainIndexBuffer& indices
 )
     : heightmap(heightmap),
+    normals(normals),
     chunkX(chunkX),
     chunkZ(chunkZ),
     chunkSize(chunkSize),
-    gridScale(gridScale)
+    gridScale(gridScale),
+    indices(indices)
 {
-    // Ըݵγ߶ȵֵҪ㹻סѷ
-    const float SKIRT_DEPTH = 50.0f;
-
-    buildVertices();
-
-    // 1)  Skirt 㣨ı߽߱綥
-    buildSkirtVertices(SKIRT_DEPTH);
+    // 构造只记录参数；重活在 build() 中完成（可并行）
+}
 
-    // 2)  LOD0~3 
-    buildIndices(1, indicesLOD0);
-    buildIndices(2, indicesLOD1);
-    buildIndices(4, indicesLOD2);
-    buildIndices(8, indicesLOD3);
+void TerrainChunk::build() {
+    // 1) 顶点 + Skirt 顶点（四边边界顶点的副本）
+    buildGeometry();
 
-    // 3)  LOD0~3 Skirt ı
-    buildSkirtIndicesForLOD(1, skirtIndicesLOD0);
-    buildSkirtIndicesForLOD(2, skirtIndicesLOD1);
-    buildSkirtIndicesForLOD(4, skirtIndicesLOD2);
-    buildSkirtIndicesForLOD(8, skirtIndicesLOD3);
+    // 2) bounds（包含 skirt）
+    computeBounds();
 
-    // 4) bounds skirt
-    computeBounds(SKIRT_DEPTH);
+    // GPU 上传由 TerrainSystem 按渲染模式决定
+}
 
-    // 5) ϴ GPU
-    setupMesh();
+void TerrainChunk::buildGeometry() {
+    vertices.clear();
+    buildVertices();
+    buildSkirtVertices();
 }
 
 void TerrainChunk::buildVertices() {
+    vertices.reserve(TerrainIndexBuffer::vertexCount(chunkSize));
     vertices.resize(chunkSize * chunkSize);
 
     int startX = chunkX * (chunkSize - 1);
     int startZ = chunkZ * (chunkSize - 1);
 
+    // 高度与法线都按行连续读取；法线直接拷贝法线场里的编码（边界顶点与相邻 chunk 共用同一份）
     for (int z = 0; z < chunkSize; ++z) {
+        const unsigned short* heights = heightmap.row(startZ + z) + startX;
+        const int16_t* encoded = normals.at(startX, startZ + z);
         for (int x = 0; x < chunkSize; ++x) {
-            int hx = startX + x;
-            int hz = startZ + z;
-
-            float y = heightmap.get(hx, hz);
-
             TerrainVertex v;
-            float halfW = (heightmap.width - 1) * gridScale * 0.5f;
-            float halfH = (heightmap.height - 1) * gridScale * 0.5f;
-
-            v.Position = glm::vec3(
-                hx * gridScale - halfW,
-                y,
-                hz * gridScale - halfH
-            );
-
-            // ԰ȫ heightmap һ
-            v.TexCoords = glm::vec2(
-                float(hx) / (heightmap.width - 1),
-                float(hz) / (heightmap.height - 1)
-            );
-
-            // 
-            v.Normal = calculateNormal(hx, hz);
+            v.Height = heights[x];
+            v.Normal[0] = encoded[x * 2];
+            v.Normal[1] = encoded[x * 2 + 1];
+            v.Padding = 0;
 
             vertices[z * chunkSize + x] = v;
         }
     }
 }
 
-void TerrainChunk::buildIndices(int step, std::vector<unsigned int>& out) {
-    // Ҫ chunkSize-1 ܱ step һ/л
-    for (int z = 0; z < chunkSize - 1; z += step) {
-        for (int x = 0; x < chunkSize - 1; x += step) {
-            int tl = z * chunkSize + x;
-            int tr = tl + step;
-            int bl = (z + step) * chunkSize + x;
-            int br = bl + step;
-
-            out.push_back(tl);
-            out.push_back(bl);
-            out.push_back(tr);
-
-            out.push_back(tr);
-            out.push_back(bl);
-            out.push_back(br);
-        }
-    }
-}
-
-void TerrainChunk::buildSkirtVertices(float skirtDepth) {
+void TerrainChunk::buildSkirtVertices() {
     const int N = chunkSize;
 
-    skirtMap.assign(N * N, -1);
-
-    // Ϊб߽綥㴴 corner ظ
+    // 为所有边界顶点创建副本（按行优先顺序，与 TerrainIndexBuffer 的 skirtMap 及 terrain.vs 一致）
     for (int z = 0; z < N; ++z) {
         for (int x = 0; x < N; ++x) {
             if (!isBoundary(x, z, N)) continue;
-
-            int baseIdx = z * N + x;
-
-            TerrainVertex sv = vertices[baseIdx];
-            sv.Position.y -= skirtDepth;
-
-            int skirtIdx = (int)vertices.size();
-            vertices.push_back(sv);
-            skirtMap[baseIdx] = skirtIdx;
+            vertices.push_back(vertices[z * N + x]);
         }
     }
 }
 
-static inline void addSkirtQuad(
-    int v0, int v1, int sv0, int sv1,
-    std::vector<unsigned int>& out
-) {
-    // γһıΣv0-v1-sv1-sv0
-    // Σ (v0, sv0, v1), (v1, sv0, sv1)
-    out.push_back((unsigned)v0);
-    out.push_back((unsigned)sv0);
-    out.push_back((unsigned)v1);
-
-    out.push_back((unsigned)v1);
-    out.push_back((unsigned)sv0);
-    out.push_back((unsigned)sv1);
-}
-
-void TerrainChunk::buildSkirtIndicesForLOD(int step, std::vector<unsigned int>& out) {
+void TerrainChunk::computeBounds() {
     const int N = chunkSize;
-
-    // -------- ϱߣz=0x: 0->N-1--------
-    {
-        int z = 0;
-        for (int x = 0; x < N - step; x += step) {
-            int v0 = z * N + x;
-            int v1 = z * N + (x + step);
-            int sv0 = skirtMap[v0];
-            int sv1 = skirtMap[v1];
-            addSkirtQuad(v0, v1, sv0, sv1, out);
-        }
-    }
-
-    // -------- ұߣx=N-1z: 0->N-1--------
-    {
-        int x = N - 1;
-        for (int z = 0; z < N - step; z += step) {
-            int v0 = z * N + x;
-            int v1 = (z + step) * N + x;
-            int sv0 = skirtMap[v0];
-            int sv1 = skirtMap[v1];
-            addSkirtQuad(v0, v1, sv0, sv1, out);
-        }
-    }
-
-    // -------- ±ߣz=N-1x: N-1->0--------
-    // һ飬֤Ʒһ£Ǳ룬ͳһ޳淽
-    {
-        int z = N - 1;
-        for (int x = N - 1; x - step >= 0; x -= step) {
-            int v0 = z * N + x;
-            int v1 = z * N + (x - step);
-            int sv0 = skirtMap[v0];
-            int sv1 = skirtMap[v1];
-            addSkirtQuad(v0, v1, sv0, sv1, out);
-        }
-    }
-
-    // -------- ߣx=0z: N-1->0--------
-    {
-        int x = 0;
-        for (int z = N - 1; z - step >= 0; z -= step) {
-            int v0 = z * N + x;
-            int v1 = (z - step) * N + x;
-            int sv0 = skirtMap[v0];
-            int sv1 = skirtMap[v1];
-            addSkirtQuad(v0, v1, sv0, sv1, out);
+    const float toWorld = heightmap.heightScale / 65535.0f;
+    int startX = chunkX * (N - 1);
+    int startZ = chunkZ * (N - 1);
+
+    // Y：整体范围取自 heightmap 的 min/max 金字塔（对齐的 chunk 恰好是一个节点）；
+    // skirt 即边界顶点下拉 skirtDepth，只需扫描四条边
+    HeightPyramid::MinMax range = heightmap.getRangeRaw(startX, startZ, startX + N - 1, startZ + N - 1);
+    unsigned short minRaw = range.min, maxRaw = range.max, minBorderRaw = 65535;
+    if (skirtDepth > 0.0f) {
+        const unsigned short* top = heightmap.row(startZ) + startX;
+        const unsigned short* bottom = heightmap.row(startZ + N - 1) + startX;
+        for (int i = 0; i < N; ++i) {
+            minBorderRaw = std::min(minBorderRaw, std::min(top[i], bottom[i]));
+            minBorderRaw = std::min(minBorderRaw, heightmap.getRaw(startX, startZ + i));
+            minBorderRaw = std::min(minBorderRaw, heightmap.getRaw(startX + N - 1, startZ + i));
         }
     }
-}
+    float minY = std::min(minRaw * toWorld, minBorderRaw * toWorld - skirtDepth);
+    float maxY = maxRaw * toWorld;
 
-void TerrainChunk::computeBounds(float skirtDepth) {
-    glm::vec3 mn(std::numeric_limits<float>::max());
-    glm::vec3 mx(-std::numeric_limits<float>::max());
+    // X/Z：由网格范围直接得到
+    float halfW = (heightmap.width - 1) * gridScale * 0.5f;
+    float halfH = (heightmap.height - 1) * gridScale * 0.5f;
 
-    for (const auto& v : vertices) {
-        mn = glm::min(mn, v.Position);
-        mx = glm::max(mx, v.Position);
-    }
+    glm::vec3 mn(startX * gridScale - halfW, minY, startZ * gridScale - halfH);
+    glm::vec3 mx((startX + N - 1) * gridScale - halfW, maxY, (startZ + N - 1) * gridScale - halfH);
 
-    // ˸ eps
+    // 防闪烁 eps
     const float eps = 1.0f;
     mn -= glm::vec3(eps);
     mx += glm::vec3(eps);
@@ -287,22 +222,55 @@ void TerrainChunk::computeBounds(float skirtDepth) {
     bounds.max = mx;
 
     center = 0.5f * (bounds.min + bounds.max);
+
+    computeLODErrors();
+}
+
+void TerrainChunk::computeLODErrors() {
+    const int N = chunkSize;
+    const float toWorld = heightmap.heightScale / 65535.0f;
+    const int startX = chunkX * (N - 1);
+    const int startZ = chunkZ * (N - 1);
+
+    lodError[0] = 0.0f;
+    for (int lod = 1; lod < TerrainIndexBuffer::LOD_COUNT; ++lod) {
+        const int step = TerrainIndexBuffer::lodStep(lod);
+        const float invStep = 1.0f / step;
+        float maxError = 0.0f;
+
+        for (int cz = 0; cz < N - 1; cz += step) {
+            for (int cx = 0; cx < N - 1; cx += step) {
+                const unsigned short* r0 = heightmap.row(startZ + cz) + startX + cx;
+                const unsigned short* r1 = heightmap.row(startZ + cz + step) + startX + cx;
+                float tl = r0[0], tr = r0[step];
+                float bl = r1[0], br = r1[step];
+
+                // 单元内每个原始采样与所在三角形插值的差
+                for (int j = 0; j <= step; ++j) {
+                    const unsigned short* row = heightmap.row(startZ + cz + j) + startX + cx;
+                    float v = j * invStep;
+                    for (int i = 0; i <= step; ++i) {
+                        float u = i * invStep;
+                        float h = (u + v <= 1.0f)
+                            ? tl + u * (tr - tl) + v * (bl - tl)
+                            : br + (1.0f - u) * (bl - br) + (1.0f - v) * (tr - br);
+                        maxError = std::max(maxError, std::fabs(row[i] - h));
+                    }
+                }
+            }
+        }
+
+        // 更粗的 LOD 误差不应小于更细的，保证选择时单调
+        lodError[lod] = std::max(maxError * toWorld, lodError[lod - 1]);
+    }
 }
 
 void TerrainChunk::setupMesh() {
+    if (VAO != 0) return;
+
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
 
-    glGenBuffers(1, &EBOLOD0);
-    glGenBuffers(1, &EBOLOD1);
-    glGenBuffers(1, &EBOLOD2);
-    glGenBuffers(1, &EBOLOD3);
-
-    glGenBuffers(1, &EBOSkirt0);
-    glGenBuffers(1, &EBOSkirt1);
-    glGenBuffers(1, &EBOSkirt2);
-    glGenBuffers(1, &EBOSkirt3);
-
     glBindVertexArray(VAO);
 
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
@@ -311,134 +279,29 @@ void TerrainChunk::setupMesh() {
         vertices.data(),
         GL_STATIC_DRAW);
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, Position));
+    setupTerrainVertexAttribs();
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, Normal));
-
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE,
-        sizeof(TerrainVertex), (void*)offsetof(TerrainVertex, TexCoords));
-
-    //  EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD0);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        indicesLOD0.size() * sizeof(unsigned int),
-        indicesLOD0.data(),
-        GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD1);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        indicesLOD1.size() * sizeof(unsigned int),
-        indicesLOD1.data(),
-        GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD2);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        indicesLOD2.size() * sizeof(unsigned int),
-        indicesLOD2.data(),
-        GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD3);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        indicesLOD3.size() * sizeof(unsigned int),
-        indicesLOD3.data(),
-        GL_STATIC_DRAW);
-
-    // Skirt EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt0);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        skirtIndicesLOD0.size() * sizeof(unsigned int),
-        skirtIndicesLOD0.data(),
-        GL_STATIC_DRAW);
+    // 共享 EBO 记录进本 chunk 的 VAO，Draw 时无需再绑定
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.getEBO());
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt1);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        skirtIndicesLOD1.size() * sizeof(unsigned int),
-        skirtIndicesLOD1.data(),
-        GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt2);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        skirtIndicesLOD2.size() * sizeof(unsigned int),
-        skirtIndicesLOD2.data(),
-        GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt3);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
-        skirtIndicesLOD3.size() * sizeof(unsigned int),
-        skirtIndicesLOD3.data(),
-        GL_STATIC_DRAW);
+void TerrainChunk::updateMesh() {
+    if (VAO == 0) return;
 
-    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(TerrainVertex), vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void TerrainChunk::Draw(Shader& shader, int lod) {
-    // clamp lod
-    if (lod < 0) lod = 0;
-    if (lod > 3) lod = 3;
+    // 主体与 skirt 在共享 EBO 中相邻，一次绘制完成
+    Draw(shader, indices.combined(lod));
+}
 
+void TerrainChunk::Draw(Shader& shader, const TerrainIndexRange& range) {
     glBindVertexArray(VAO);
-
-    // -------  -------
-    switch (lod) {
-    case 0:
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD0);
-        glDrawElements(GL_TRIANGLES, (GLsizei)indicesLOD0.size(), GL_UNSIGNED_INT, 0);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt0);
-        glDrawElements(GL_TRIANGLES, (GLsizei)skirtIndicesLOD0.size(), GL_UNSIGNED_INT, 0);
-        break;
-
-    case 1:
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD1);
-        glDrawElements(GL_TRIANGLES, (GLsizei)indicesLOD1.size(), GL_UNSIGNED_INT, 0);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt1);
-        glDrawElements(GL_TRIANGLES, (GLsizei)skirtIndicesLOD1.size(), GL_UNSIGNED_INT, 0);
-        break;
-
-    case 2:
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD2);
-        glDrawElements(GL_TRIANGLES, (GLsizei)indicesLOD2.size(), GL_UNSIGNED_INT, 0);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt2);
-        glDrawElements(GL_TRIANGLES, (GLsizei)skirtIndicesLOD2.size(), GL_UNSIGNED_INT, 0);
-        break;
-
-    case 3:
-    default:
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOLOD3);
-        glDrawElements(GL_TRIANGLES, (GLsizei)indicesLOD3.size(), GL_UNSIGNED_INT, 0);
-
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOSkirt3);
-        glDrawElements(GL_TRIANGLES, (GLsizei)skirtIndicesLOD3.size(), GL_UNSIGNED_INT, 0);
-        break;
-    }
-
+    glDrawElements(GL_TRIANGLES, (GLsizei)range.count, GL_UNSIGNED_SHORT, (void*)range.offset);
     glBindVertexArray(0);
 }
-
-glm::vec3 TerrainChunk::calculateNormal(int hx, int hz) const
-{
-    // ʹȫ heightmap 
-    float hl = heightmap.get(hx - 1, hz);
-    float hr = heightmap.get(hx + 1, hz);
-    float hd = heightmap.get(hx, hz - 1);
-    float hu = heightmap.get(hx, hz + 1);
-
-    // X/Z  = gridScale
-    // ֣y ൱ڡֱȨء
-    glm::vec3 n(
-        hl - hr,
-        2.0f * gridScale,
-        hd - hu
-    );
-
-    return glm::normalize(n);
-}
-
-
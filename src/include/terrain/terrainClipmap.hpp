@@ -0,0 +1,361 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <glm/glm.hpp>
+#include "heightmap.hpp"
+#include "frustumCulling.hpp"
+#include "terrainIndexBuffer.hpp"
+#include "../shader.hpp"
+
+// clipmap.vs 中 uClipHeights（高度纹理数组）使用的纹理单元，接在实例化模式的高度 / 法线（4 / 5）之后
+static constexpr int TERRAIN_CLIPMAP_TEXTURE_UNIT = 6;
+
+// clipmap 参数（构造 Terrain 时传入，只在第一次切到 Clipmap 模式时生效）
+struct TerrainClipmapSettings {
+    int levels = 0;         // 层数；0 = 自动取足以从地形任意位置覆盖整张 heightmap 的层数
+    int gridCells = 248;    // 每层每边单元数（4 的倍数，8 ~ 248）
+    int morphCells = 0;     // 外边界过渡带宽度（单元）；0 = gridCells / 10
+};
+
+// ====================== TerrainClipmap ======================
+// 几何 clipmap：以相机为中心的 L 层同尺寸网格，第 l 层的格距为 gridScale * 2^l。
+//   - 所有层共用一份 (K+1)x(K+1) 网格拓扑（只有 EBO，顶点位置在 clipmap.vs 中由 gl_VertexID 重建）
+//   - 每层高度存在 GL_TEXTURE_2D_ARRAY 的一层中，按环形（toroidal）寻址；相机移动时只上传新进入窗口的行 / 列
+//   - 第 l 层挖去第 l-1 层占据的中心区域；由于层原点按粗一级格距对齐，洞相对本层只有 0 / 1 格的偏移，
+//     预先生成 4 种环形索引 + 1 个完整网格
+//   - 每层外边界附近的顶点高度 / 法线逐渐过渡到粗一级的插值，边界上与粗层的边完全重合，没有裂缝
+// 每帧 CPU 开销只与层数和相机位移有关，与地形大小无关。
+// =============================================================
+class TerrainClipmap {
+public:
+    TerrainClipmap() = default;
+    ~TerrainClipmap() { release(); }
+
+    TerrainClipmap(const TerrainClipmap&) = delete;
+    TerrainClipmap& operator=(const TerrainClipmap&) = delete;
+
+    // 创建高度纹理数组与共享索引（只在第一次调用时生效）
+    void build(const Heightmap& heightmap, float gridScale, const TerrainClipmapSettings& settings);
+    void release();
+    bool isBuilt() const { return VAO != 0; }
+
+    // 按相机位置环形更新各层高度，然后逐层绘制（shader 须已 use，material / 矩阵 uniform 由调用者设置）
+    void render(Shader& shader, const glm::mat4& viewProj, const glm::vec3& cameraPos);
+
+    // heightmap 采样矩形 [x0, x1] x [z0, z1] 被修改后，重传各有效层窗口中与之相交的格点
+    void refreshRegion(int x0, int z0, int x1, int z1);
+
+    int getLevelCount() const { return levelCount; }
+    // 上一帧的 draw call 数与上传的高度采样数
+    int getDrawCount() const { return drawCount; }
+    int getUploadedTexels() const { return uploadedTexels; }
+
+private:
+    void buildIndices();
+    // 更新第 level 层的窗口，使其以 origin 为网格原点
+    void updateLevel(int level, const glm::ivec2& origin);
+    // 把第 level 层格点 [x0, x1) x [z0, z1) 的高度写入纹理（按环形寻址拆成至多 4 块）
+    void uploadRegion(int level, int x0, int z0, int x1, int z1);
+
+    enum { RANGE_FULL = 0, RANGE_RING = 1, RANGE_COUNT = 5 };
+
+private:
+    const Heightmap* heightmap = nullptr;
+    float gridScale = 1.0f;
+
+    int levelCount = 0;
+    int gridCells = 0;      // K：每层每边单元数
+    int morphCells = 0;
+    int texSize = 0;        // 环形纹理边长（2 的幂，>= K + 5：网格外各留 2 格给法线 / 过渡的差分）
+
+    // 每层当前网格原点（本层格点坐标）与纹理内容是否有效
+    std::vector<glm::ivec2> origins;
+    std::vector<char> valid;
+    std::vector<uint16_t> staging;
+
+    TerrainIndexRange ranges[RANGE_COUNT];
+
+    int drawCount = 0;
+    int uploadedTexels = 0;
+
+    unsigned int VAO = 0;
+    unsigned int EBO = 0;
+    unsigned int heightTexture = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainClipmap::build(const Heightmap& inHeightmap, float inGridScale, const TerrainClipmapSettings& settings) {
+    if (VAO != 0) return;
+
+    heightmap = &inHeightmap;
+    gridScale = inGridScale;
+
+    // 单元数取 4 的倍数：半宽 M = K/2 为偶数，层原点才能对齐到粗一级格点；(K+1)^2 个顶点须在 u16 索引范围内
+    gridCells = std::clamp(settings.gridCells / 4 * 4, 8, 248);
+    const int M = gridCells / 2;
+    morphCells = (settings.morphCells > 0) ? settings.morphCells : gridCells / 10;
+    morphCells = std::clamp(morphCells, 1, M / 2 - 1);
+
+    texSize = 1;
+    while (texSize < gridCells + 5) texSize <<= 1;
+
+    // 自动层数：最粗一层的半宽（M * 2^(L-1) 个采样）覆盖 heightmap 的最大边长
+    levelCount = settings.levels;
+    if (levelCount <= 0) {
+        int maxCells = std::max(heightmap->width, heightmap->height) - 1;
+        levelCount = 1;
+        while ((M << (levelCount - 1)) < maxCells && levelCount < 16) ++levelCount;
+    }
+    levelCount = std::clamp(levelCount, 1, 16);
+
+    origins.assign(levelCount, glm::ivec2(0));
+    valid.assign(levelCount, 0);
+
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R16, texSize, texSize, levelCount, 0, GL_RED, GL_UNSIGNED_SHORT, nullptr);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+    buildIndices();
+
+    int extent = (gridCells << (levelCount - 1));
+    std::cout << "[Terrain] Clipmap: " << levelCount << " levels of " << gridCells << "x" << gridCells
+        << " cells, " << texSize << "x" << texSize << " R16 ring textures, coarsest level spans "
+        << extent * gridScale << " m" << std::endl;
+}
+
+inline void TerrainClipmap::buildIndices() {
+    const int K = gridCells;
+    const int M = K / 2;
+    const int stride = K + 1;
+
+    std::vector<uint16_t> indices;
+    auto addCells = [&](int holeX, int holeZ) {
+        for (int z = 0; z < K; ++z) {
+            for (int x = 0; x < K; ++x) {
+                // 洞：细一层占据的 M x M 个单元
+                if (holeX >= 0 && x >= holeX && x < holeX + M && z >= holeZ && z < holeZ + M) continue;
+
+                // 与 TerrainIndexBuffer 相同的三角形划分（对角线 tr - bl），clipmap.vs 的过渡插值依赖这一点
+                int tl = z * stride + x;
+                int tr = tl + 1;
+                int bl = tl + stride;
+                int br = bl + 1;
+                indices.push_back((uint16_t)tl); indices.push_back((uint16_t)bl); indices.push_back((uint16_t)tr);
+                indices.push_back((uint16_t)tr); indices.push_back((uint16_t)bl); indices.push_back((uint16_t)br);
+            }
+        }
+    };
+
+    // 0：完整网格（最细的活动层）；1 + dx + 2 * dz：洞起点为 (M/2 + dx, M/2 + dz) 的环
+    for (int r = 0; r < RANGE_COUNT; ++r) {
+        size_t begin = indices.size();
+        if (r == RANGE_FULL) addCells(-1, -1);
+        else addCells(M / 2 + ((r - RANGE_RING) & 1), M / 2 + ((r - RANGE_RING) >> 1));
+        ranges[r].offset = begin * sizeof(uint16_t);
+        ranges[r].count = (int)(indices.size() - begin);
+    }
+
+    // 只有 EBO 的 VAO：顶点位置全部由 gl_VertexID 与纹理得到
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &EBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint16_t), indices.data(), GL_STATIC_DRAW);
+    glBindVertexArray(0);
+}
+
+inline void TerrainClipmap::release() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &EBO);
+        VAO = 0;
+        EBO = 0;
+    }
+    if (heightTexture != 0) glDeleteTextures(1, &heightTexture);
+    heightTexture = 0;
+}
+
+inline void TerrainClipmap::uploadRegion(int level, int x0, int z0, int x1, int z1) {
+    const int mask = texSize - 1;
+    const int maxX = heightmap->width - 1;
+    const int maxZ = heightmap->height - 1;
+    // 格点坐标在地图边缘可能为负，用乘法而不是左移（负数左移是未定义行为）
+    const int step = 1 << level;
+
+    // 沿 x / z 在环形边界处切开，每块在纹理中连续
+    for (int z = z0; z < z1;) {
+        int tz = z & mask;
+        int lenZ = std::min(z1 - z, texSize - tz);
+        for (int x = x0; x < x1;) {
+            int tx = x & mask;
+            int lenX = std::min(x1 - x, texSize - tx);
+
+            // 第 level 层格点 (i, j) 对应 heightmap 采样 (i * 2^level, j * 2^level)，超出范围取边缘
+            staging.resize((size_t)lenX * lenZ);
+            for (int j = 0; j < lenZ; ++j) {
+                const unsigned short* row = heightmap->row(std::clamp((z + j) * step, 0, maxZ));
+                uint16_t* out = &staging[(size_t)j * lenX];
+                for (int i = 0; i < lenX; ++i) {
+                    out[i] = row[std::clamp((x + i) * step, 0, maxX)];
+                }
+            }
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, tx, tz, level, lenX, lenZ, 1,
+                GL_RED, GL_UNSIGNED_SHORT, staging.data());
+            uploadedTexels += lenX * lenZ;
+
+            x += lenX;
+        }
+        z += lenZ;
+    }
+}
+
+inline void TerrainClipmap::updateLevel(int level, const glm::ivec2& origin) {
+    // 纹理窗口：格点 [origin - 2, origin + K + 3)，网格外各多 2 格供中央差分 / 过渡使用
+    const int W = gridCells + 5;
+    const glm::ivec2 lo = origin - 2;
+
+    if (!valid[level] || std::abs(origin.x - origins[level].x) >= W || std::abs(origin.y - origins[level].y) >= W) {
+        uploadRegion(level, lo.x, lo.y, lo.x + W, lo.y + W);
+    }
+    else {
+        // 只补新进入窗口的列与行；旧数据在环形纹理中原地保留
+        const glm::ivec2 old = origins[level] - 2;
+        if (lo.x > old.x) uploadRegion(level, old.x + W, lo.y, lo.x + W, lo.y + W);
+        if (lo.x < old.x) uploadRegion(level, lo.x, lo.y, old.x, lo.y + W);
+        if (lo.y > old.y) uploadRegion(level, lo.x, old.y + W, lo.x + W, lo.y + W);
+        if (lo.y < old.y) uploadRegion(level, lo.x, lo.y, lo.x + W, old.y);
+    }
+
+    origins[level] = origin;
+    valid[level] = 1;
+}
+
+inline void TerrainClipmap::refreshRegion(int x0, int z0, int x1, int z1) {
+    if (VAO == 0) return;
+
+    const int W = gridCells + 5;
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    for (int l = 0; l < levelCount; ++l) {
+        if (!valid[l]) continue;
+
+        // 第 l 层格点 i 取采样 i << l：覆盖 [x0, x1] 的格点为 [ceil(x0 / 2^l), floor(x1 / 2^l)]；
+        // 超出 heightmap 的格点取边缘采样，矩形贴边时窗口外侧的格点也要重传
+        const int step = 1 << l;
+        int gx0 = (x0 + step - 1) >> l, gx1 = x1 >> l;
+        int gz0 = (z0 + step - 1) >> l, gz1 = z1 >> l;
+        if (x0 == 0) gx0 = INT_MIN / 2;
+        if (z0 == 0) gz0 = INT_MIN / 2;
+        if (x1 == heightmap->width - 1) gx1 = INT_MAX / 2;
+        if (z1 == heightmap->height - 1) gz1 = INT_MAX / 2;
+
+        const glm::ivec2 lo = origins[l] - 2;
+        gx0 = std::max(gx0, lo.x); gx1 = std::min(gx1, lo.x + W - 1);
+        gz0 = std::max(gz0, lo.y); gz1 = std::min(gz1, lo.y + W - 1);
+        if (gx0 > gx1 || gz0 > gz1) continue;
+
+        uploadRegion(l, gx0, gz0, gx1 + 1, gz1 + 1);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+}
+
+inline void TerrainClipmap::render(Shader& shader, const glm::mat4& viewProj, const glm::vec3& cameraPos) {
+    drawCount = 0;
+    uploadedTexels = 0;
+    if (VAO == 0) return;
+
+    const int K = gridCells;
+    const int M = K / 2;
+    const float halfW = (heightmap->width - 1) * gridScale * 0.5f;
+    const float halfH = (heightmap->height - 1) * gridScale * 0.5f;
+
+    // 相机所在的 heightmap 网格坐标
+    const float camX = (cameraPos.x + halfW) / gridScale;
+    const float camZ = (cameraPos.z + halfH) / gridScale;
+
+    // 离地越高，细层投影越小：跳过边长小于离地高度的细层，第一个活动层画完整网格
+    int camSampleX = std::clamp((int)std::floor(camX), 0, heightmap->width - 1);
+    int camSampleZ = std::clamp((int)std::floor(camZ), 0, heightmap->height - 1);
+    float altitude = std::max(cameraPos.y - heightmap->get(camSampleX, camSampleZ), 0.0f);
+    int firstLevel = 0;
+    while (firstLevel + 1 < levelCount && (K << firstLevel) * gridScale < altitude) {
+        valid[firstLevel] = 0;
+        ++firstLevel;
+    }
+
+    // 1. 各层原点对齐到粗一级格点（本层格点坐标为偶数），并环形更新纹理
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    for (int l = firstLevel; l < levelCount; ++l) {
+        glm::ivec2 origin(
+            2 * (int)std::floor(camX / (float)(2 << l)) - M,
+            2 * (int)std::floor(camZ / (float)(2 << l)) - M
+        );
+        updateLevel(l, origin);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // 2. 共享 uniform
+    shader.setInt("uClipCells", K);
+    shader.setInt("uClipTexMask", texSize - 1);
+    shader.setFloat("uMorphCells", (float)morphCells);
+    shader.setFloat("uGridScale", gridScale);
+    shader.setFloat("uHeightScale", heightmap->heightScale);
+    shader.setVec2("uHalfExtent", glm::vec2(halfW, halfH));
+    shader.setVec2("uInvGridSize", glm::vec2(1.0f / (heightmap->width - 1), 1.0f / (heightmap->height - 1)));
+    shader.setVec2("uMaxGrid", glm::vec2(heightmap->width - 1, heightmap->height - 1));
+
+    glActiveTexture(GL_TEXTURE0 + TERRAIN_CLIPMAP_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, heightTexture);
+    glActiveTexture(GL_TEXTURE0);
+
+    Frustum frustum;
+    frustum.updateFromMatrix(viewProj);
+
+    // 3. 逐层绘制：每层一次 glDrawElements
+    glBindVertexArray(VAO);
+    for (int l = firstLevel; l < levelCount; ++l) {
+        const glm::ivec2 origin = origins[l];
+
+        // 本层覆盖的采样矩形（裁剪到 heightmap 内）；完全在地形外或视锥外则跳过
+        // （origin 在地图边缘为负，按乘法换算）
+        const int step = 1 << l;
+        int x0 = std::max(origin.x * step, 0);
+        int z0 = std::max(origin.y * step, 0);
+        int x1 = std::min((origin.x + K) * step, heightmap->width - 1);
+        int z1 = std::min((origin.y + K) * step, heightmap->height - 1);
+        if (x0 >= x1 || z0 >= z1) continue;
+
+        AABB box;
+        box.min = glm::vec3(x0 * gridScale - halfW, heightmap->getMinHeight(x0, z0, x1, z1), z0 * gridScale - halfH);
+        box.max = glm::vec3(x1 * gridScale - halfW, heightmap->getMaxHeight(x0, z0, x1, z1), z1 * gridScale - halfH);
+        if (!frustum.intersects(box)) continue;
+
+        // 洞相对本层的偏移：细一层原点换算到本层格点后减去 M/2，只可能是 0 或 1
+        int range = RANGE_FULL;
+        if (l > firstLevel) {
+            glm::ivec2 hole = (origins[l - 1] - 2 * origin) / 2 - M / 2;
+            range = RANGE_RING + std::clamp(hole.x, 0, 1) + 2 * std::clamp(hole.y, 0, 1);
+        }
+
+        shader.setInt("uLevel", l);
+        shader.setIVec2("uLevelOrigin", origin);
+        shader.setFloat("uMorph", (l + 1 < levelCount) ? 1.0f : 0.0f);
+
+        glDrawElements(GL_TRIANGLES, ranges[range].count, GL_UNSIGNED_SHORT, (const void*)ranges[range].offset);
+        ++drawCount;
+    }
+    glBindVertexArray(0);
+}
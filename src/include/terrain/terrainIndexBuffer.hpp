@@ -0,0 +1,250 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <iostream>
+
+// ====================== TerrainIndexBuffer ======================
+// 所有 TerrainChunk 的网格拓扑完全相同（chunkSize x chunkSize + 四边 skirt），
+// 因此 LOD0~3 及其 skirt 索引只需生成一份，由 TerrainSystem 持有并共享给所有 chunk。
+//
+// GPU 布局（单个 EBO，16 位索引）：
+//   [LOD0 主体][LOD0 skirt][LOD0 缝合变体 1..15][LOD1 主体][LOD1 skirt] ...
+// 同一 LOD 的主体与 skirt 相邻，一次 glDrawElements 即可画完。
+//
+// 缝合变体：4 位掩码的每一位表示该边的邻居比自己粗一级，
+// 此时该边上不落在粗网格上的顶点吸附到前一个粗网格顶点，边线与邻居完全重合，无需 skirt。
+// ================================================================
+
+// 缝合掩码位：对应边的邻居 LOD 更粗
+enum TerrainStitchEdge {
+    STITCH_TOP = 1,     // z = 0     （-Z 邻居）
+    STITCH_RIGHT = 2,   // x = N - 1 （+X 邻居）
+    STITCH_BOTTOM = 4,  // z = N - 1 （+Z 邻居）
+    STITCH_LEFT = 8     // x = 0     （-X 邻居）
+};
+
+// 一段连续索引：count 为索引个数，offset 为 EBO 内的字节偏移
+struct TerrainIndexRange {
+    int count = 0;
+    size_t offset = 0;
+};
+
+// 判断 (x, z) 是否为 N x N 网格的边界顶点
+static inline bool isBoundary(int x, int z, int N) {
+    return (x == 0 || z == 0 || x == N - 1 || z == N - 1);
+}
+
+class TerrainIndexBuffer {
+public:
+    static constexpr int LOD_COUNT = 4;
+    static constexpr int STITCH_MASK_COUNT = 16;
+
+    TerrainIndexBuffer() = default;
+    ~TerrainIndexBuffer() { release(); }
+
+    TerrainIndexBuffer(const TerrainIndexBuffer&) = delete;
+    TerrainIndexBuffer& operator=(const TerrainIndexBuffer&) = delete;
+
+    // 生成 CPU 索引并上传 GPU（整个 TerrainSystem 只调用一次）
+    void build(int chunkSize);
+    // 释放 EBO
+    void release();
+
+    unsigned int getEBO() const { return EBO; }
+
+    // 某个 LOD 的主体 / skirt / 主体+skirt 区间
+    const TerrainIndexRange& body(int lod) const { return bodyRanges[clampLOD(lod)][0]; }
+    const TerrainIndexRange& skirt(int lod) const { return skirtRanges[clampLOD(lod)]; }
+    TerrainIndexRange combined(int lod) const {
+        TerrainIndexRange r = body(lod);
+        r.count += skirt(lod).count;
+        return r;
+    }
+
+    // 缝合变体（不含 skirt）；mask 为 TerrainStitchEdge 的组合，0 即普通主体
+    const TerrainIndexRange& stitched(int lod, int mask) const {
+        return bodyRanges[clampLOD(lod)][mask & (STITCH_MASK_COUNT - 1)];
+    }
+
+    // LOD -> 采样步长（1, 2, 4, 8）
+    static int lodStep(int lod) { return 1 << clampLOD(lod); }
+    static int clampLOD(int lod) { return lod < 0 ? 0 : (lod >= LOD_COUNT ? LOD_COUNT - 1 : lod); }
+
+    // 每个 chunk 的顶点数（主体 + skirt）
+    static int vertexCount(int chunkSize) { return chunkSize * chunkSize + 4 * (chunkSize - 1); }
+
+private:
+    void buildSkirtMap();
+    void buildBodyIndices(int step, int mask, std::vector<uint16_t>& out) const;
+    void buildSkirtIndices(int step, std::vector<uint16_t>& out) const;
+
+private:
+    int chunkSize = 0;
+
+    // 原始边界顶点 index -> 对应 skirt 顶点 index（在主体顶点之后）
+    // 顺序必须与 TerrainChunk::buildSkirtVertices 一致：按行优先遍历边界顶点
+    std::vector<int> skirtMap;
+
+    TerrainIndexRange bodyRanges[LOD_COUNT][STITCH_MASK_COUNT];
+    TerrainIndexRange skirtRanges[LOD_COUNT];
+
+    unsigned int EBO = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainIndexBuffer::build(int inChunkSize) {
+    if (EBO != 0) return; // 已生成过，直接复用
+
+    chunkSize = inChunkSize;
+
+    if (vertexCount(chunkSize) > 65536) {
+        std::cerr << "TerrainIndexBuffer: chunkSize " << chunkSize
+            << " too large for 16-bit indices" << std::endl;
+        return;
+    }
+
+    buildSkirtMap();
+
+    std::vector<uint16_t> all;
+    std::vector<uint16_t> tmp;
+
+    for (int lod = 0; lod < LOD_COUNT; ++lod) {
+        int step = lodStep(lod);
+
+        tmp.clear();
+        buildBodyIndices(step, 0, tmp);
+        bodyRanges[lod][0].offset = all.size() * sizeof(uint16_t);
+        bodyRanges[lod][0].count = (int)tmp.size();
+        all.insert(all.end(), tmp.begin(), tmp.end());
+
+        tmp.clear();
+        buildSkirtIndices(step, tmp);
+        skirtRanges[lod].offset = all.size() * sizeof(uint16_t);
+        skirtRanges[lod].count = (int)tmp.size();
+        all.insert(all.end(), tmp.begin(), tmp.end());
+
+        // 最粗一级没有更粗的邻居；粗一级步长不能整除边长时也无法缝合，变体都退化为普通主体
+        bool canStitch = (lod + 1 < LOD_COUNT) && ((chunkSize - 1) % (step * 2) == 0);
+        for (int mask = 1; mask < STITCH_MASK_COUNT; ++mask) {
+            if (!canStitch) {
+                bodyRanges[lod][mask] = bodyRanges[lod][0];
+                continue;
+            }
+            tmp.clear();
+            buildBodyIndices(step, mask, tmp);
+            bodyRanges[lod][mask].offset = all.size() * sizeof(uint16_t);
+            bodyRanges[lod][mask].count = (int)tmp.size();
+            all.insert(all.end(), tmp.begin(), tmp.end());
+        }
+    }
+
+    glGenBuffers(1, &EBO);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+        all.size() * sizeof(uint16_t),
+        all.data(),
+        GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+inline void TerrainIndexBuffer::release() {
+    if (EBO != 0) {
+        glDeleteBuffers(1, &EBO);
+        EBO = 0;
+    }
+}
+
+inline void TerrainIndexBuffer::buildSkirtMap() {
+    const int N = chunkSize;
+    skirtMap.assign(N * N, -1);
+
+    int next = N * N;
+    for (int z = 0; z < N; ++z) {
+        for (int x = 0; x < N; ++x) {
+            if (!isBoundary(x, z, N)) continue;
+            skirtMap[z * N + x] = next++;
+        }
+    }
+}
+
+inline void TerrainIndexBuffer::buildBodyIndices(int step, int mask, std::vector<uint16_t>& out) const {
+    const int N = chunkSize;
+    const int coarse = step * 2;
+
+    // 网格坐标 -> 顶点 index；缝合边上的奇数顶点吸附到前一个粗网格顶点
+    auto vertex = [&](int x, int z) {
+        if ((mask & STITCH_TOP) && z == 0 && x % coarse != 0) x -= step;
+        if ((mask & STITCH_BOTTOM) && z == N - 1 && x % coarse != 0) x -= step;
+        if ((mask & STITCH_LEFT) && x == 0 && z % coarse != 0) z -= step;
+        if ((mask & STITCH_RIGHT) && x == N - 1 && z % coarse != 0) z -= step;
+        return z * N + x;
+    };
+
+    // 吸附后退化（重合或共线，例如两条缝合边的拐角）的三角形直接丢弃
+    auto triangle = [&](int a, int b, int c) {
+        int cross = (b % N - a % N) * (c / N - a / N) - (c % N - a % N) * (b / N - a / N);
+        if (cross == 0) return;
+        out.push_back((uint16_t)a);
+        out.push_back((uint16_t)b);
+        out.push_back((uint16_t)c);
+    };
+
+    // 要求 chunkSize-1 能被 step 整除，否则最后一行/列会有缺口
+    for (int z = 0; z < N - 1; z += step) {
+        for (int x = 0; x < N - 1; x += step) {
+            int tl = vertex(x, z);
+            int tr = vertex(x + step, z);
+            int bl = vertex(x, z + step);
+            int br = vertex(x + step, z + step);
+
+            triangle(tl, bl, tr);
+            triangle(tr, bl, br);
+        }
+    }
+}
+
+// 形成一个四边形：v0-v1-sv1-sv0，两个三角形 (v0, sv0, v1), (v1, sv0, sv1)
+static inline void addSkirtQuad(int v0, int v1, int sv0, int sv1, std::vector<uint16_t>& out) {
+    out.push_back((uint16_t)v0);
+    out.push_back((uint16_t)sv0);
+    out.push_back((uint16_t)v1);
+
+    out.push_back((uint16_t)v1);
+    out.push_back((uint16_t)sv0);
+    out.push_back((uint16_t)sv1);
+}
+
+inline void TerrainIndexBuffer::buildSkirtIndices(int step, std::vector<uint16_t>& out) const {
+    const int N = chunkSize;
+
+    // -------- 上边（z=0，x: 0->N-1）--------
+    for (int x = 0; x < N - step; x += step) {
+        int v0 = x;
+        int v1 = x + step;
+        addSkirtQuad(v0, v1, skirtMap[v0], skirtMap[v1], out);
+    }
+
+    // -------- 右边（x=N-1，z: 0->N-1）--------
+    for (int z = 0; z < N - step; z += step) {
+        int v0 = z * N + (N - 1);
+        int v1 = (z + step) * N + (N - 1);
+        addSkirtQuad(v0, v1, skirtMap[v0], skirtMap[v1], out);
+    }
+
+    // -------- 下边（z=N-1，x: N-1->0）--------
+    // 反向走一遍，保证绕序一致（不是必须，但方便统一剔除面方向）
+    for (int x = N - 1; x - step >= 0; x -= step) {
+        int v0 = (N - 1) * N + x;
+        int v1 = (N - 1) * N + (x - step);
+        addSkirtQuad(v0, v1, skirtMap[v0], skirtMap[v1], out);
+    }
+
+    // -------- 左边（x=0，z: N-1->0）--------
+    for (int z = N - 1; z - step >= 0; z -= step) {
+        int v0 = z * N;
+        int v1 = (z - step) * N;
+        addSkirtQuad(v0, v1, skirtMap[v0], skirtMap[v1], out);
+    }
+}
@@ -0,0 +1,360 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include "terrainChunk.hpp"
+#include "terrainIndexBuffer.hpp"
+#include "heightmap.hpp"
+#include "terrainNormalField.hpp"
+#include "../threadPool.hpp"
+
+// terrain.vs 中 uHeightTex / uNormalTex 使用的纹理单元，接在分页查找表（3）之后
+static constexpr int TERRAIN_HEIGHT_TEXTURE_UNIT = 4;
+static constexpr int TERRAIN_NORMAL_TEXTURE_UNIT = 5;
+
+// ====================== TerrainInstancer ======================
+// 顶点纹理拾取（VTF）模式：整张 heightmap 作为 R16 纹理、法线作为八面体编码的 RG16_SNORM 纹理上传一次，
+// 所有 chunk 共用同一份网格拓扑（共享 EBO，顶点位置由 gl_VertexID 重建，不需要任何 VBO）。
+// 每帧只上传一小段实例数据（chunk 坐标 + LOD），同一索引区间（LOD / 缝合变体）的 chunk
+// 用一次 glDrawElementsInstanced 画完。GL 3.3 没有 baseInstance，通过改实例属性的偏移来切换分组。
+// ===============================================================
+
+// 每实例数据（8 字节）：terrain.vs 中的 aInstance
+struct TerrainInstance {
+    int16_t chunkX;
+    int16_t chunkZ;
+    int16_t lod;
+    int16_t padding;
+};
+
+class TerrainInstancer {
+public:
+    TerrainInstancer() = default;
+    ~TerrainInstancer() { release(); }
+
+    TerrainInstancer(const TerrainInstancer&) = delete;
+    TerrainInstancer& operator=(const TerrainInstancer&) = delete;
+
+    // 上传高度 / 法线纹理并建立共享 VAO（只在第一次调用时生效）；法线第 0 层直接取共享法线场
+    void build(const Heightmap& heightmap, const TerrainNormalField& normals, int chunkCountX, int chunkCount,
+        const TerrainIndexBuffer& indices);
+    void release();
+    bool isBuilt() const { return VAO != 0; }
+
+    // heightmap 采样矩形 [x0, x1] x [z0, z1] 被修改后局部重传：高度只传该矩形，法线外扩一圈，各层 mip 只重算覆盖它的 texel
+    // （normals 须已对同一矩形 update 过）
+    void updateRegion(const Heightmap& heightmap, const TerrainNormalField& normals, int x0, int z0, int x1, int z1);
+
+    // 每帧开始时清空实例列表
+    void begin();
+    // 登记一个可见 chunk；variant 为缝合掩码（skirt 模式为 0），同一 (lod, variant) 的 chunk 合并为一次绘制
+    void add(int chunkIndex, int lod, int variant, const TerrainIndexRange& range);
+    // 上传实例数据并提交：每个非空分组一次 glDrawElementsInstanced
+    void flush();
+    // 细分模式：所有实例一次 glDrawArraysInstanced(GL_PATCHES)，每实例 patchVertices 个控制点（每 patch 4 个）
+    void flushPatches(int patchVertices);
+
+    // 绑定高度 / 法线纹理到 TERRAIN_HEIGHT_TEXTURE_UNIT / TERRAIN_NORMAL_TEXTURE_UNIT
+    void bindTextures() const;
+
+    // 上一次 flush 发出的 draw call 数
+    int getDrawCount() const { return drawCount; }
+
+private:
+    void uploadHeightTexture(const Heightmap& heightmap);
+    void uploadNormalTexture(const TerrainNormalField& normals);
+    // 由上一层（src 的原点为 (srcX0, srcZ0)、行跨度 srcStride 个 texel、整层尺寸 srcSize）求本层 [i0, i1] x [j0, j1]
+    // 的 2x2 平均，写入本层完整存储 dst（行跨度 dstStride）
+    static void downsampleNormals(const int16_t* src, int srcX0, int srcZ0, int srcStride, const glm::ivec2& srcSize,
+        int16_t* dst, int dstStride, int i0, int j0, int i1, int j1);
+
+    static constexpr int GROUP_COUNT = TerrainIndexBuffer::LOD_COUNT * TerrainIndexBuffer::STITCH_MASK_COUNT;
+
+    struct Group {
+        TerrainIndexRange range;
+        std::vector<TerrainInstance> instances;
+    };
+
+private:
+    Group groups[GROUP_COUNT];
+    std::vector<TerrainInstance> staging;   // 按分组拼接后的实例数据，每帧复用
+
+    int chunkCountX = 1;
+    int capacity = 0;
+    int drawCount = 0;
+
+    unsigned int VAO = 0;
+    unsigned int instanceVBO = 0;
+    unsigned int heightTexture = 0;
+    unsigned int normalTexture = 0;
+
+    // 法线 mip 链：各层尺寸（含第 0 层）与第 1 层起的 CPU 副本（2049^2 约 5.3 MB）。
+    // mip 在 CPU 上生成，编辑时只需重算受影响的 texel，不必对整张纹理 glGenerateMipmap
+    std::vector<glm::ivec2> mipSizes;
+    std::vector<std::vector<int16_t>> normalMips;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainInstancer::build(const Heightmap& heightmap, const TerrainNormalField& normals, int inChunkCountX, int chunkCount,
+    const TerrainIndexBuffer& indices)
+{
+    if (VAO != 0 || chunkCount <= 0) return;
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+
+    chunkCountX = inChunkCountX;
+    capacity = chunkCount;
+
+    uploadHeightTexture(heightmap);
+    uploadNormalTexture(normals);
+
+    // 共享 VAO：只有共享 EBO 与实例属性；顶点属性 0 / 1 不启用
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &instanceVBO);
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)capacity * sizeof(TerrainInstance), nullptr, GL_STREAM_DRAW);
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribIPointer(2, 4, GL_SHORT, sizeof(TerrainInstance), (void*)0);
+    glVertexAttribDivisor(2, 1);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.getEBO());
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    staging.reserve(capacity);
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "[Terrain] Instanced (VTF): uploaded " << heightmap.width << "x" << heightmap.height
+        << " height + normal textures ("
+        << (((size_t)heightmap.width * heightmap.height * 6) >> 20) << " MB) in " << ms << " ms" << std::endl;
+}
+
+inline void TerrainInstancer::uploadHeightTexture(const Heightmap& heightmap) {
+    glGenTextures(1, &heightTexture);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+
+    // 直接从带填充的采样区上传：行跨度为 rowStride，跳过两侧填充列
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, heightmap.rowStride());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R16, heightmap.width, heightmap.height, 0,
+        GL_RED, GL_UNSIGNED_SHORT, heightmap.row(0));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // terrain.vs 用 texelFetch 精确取样（不受过滤影响）；细分模式在格点之间双线性插值，不需要 mipmap
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+inline void TerrainInstancer::uploadNormalTexture(const TerrainNormalField& normals) {
+    const int w = normals.getWidth();
+    const int h = normals.getHeight();
+    const int16_t* encoded = normals.data();
+
+    glGenTextures(1, &normalTexture);
+    glBindTexture(GL_TEXTURE_2D, normalTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG16_SNORM, w, h, 0, GL_RG, GL_SHORT, encoded);
+
+    // 粗 LOD 的 chunk 取对应层 mip，光照不会因为顶点稀疏而闪烁；逐层 2x2 平均直到 1x1
+    mipSizes.assign(1, glm::ivec2(w, h));
+    normalMips.clear();
+    while (mipSizes.back().x > 1 || mipSizes.back().y > 1) {
+        const glm::ivec2 src = mipSizes.back();
+        const glm::ivec2 dst(std::max(src.x / 2, 1), std::max(src.y / 2, 1));
+        normalMips.emplace_back((size_t)dst.x * dst.y * 2);
+
+        const int16_t* srcData = (normalMips.size() == 1) ? encoded : normalMips[normalMips.size() - 2].data();
+        downsampleNormals(srcData, 0, 0, src.x, src, normalMips.back().data(), dst.x, 0, 0, dst.x - 1, dst.y - 1);
+
+        mipSizes.push_back(dst);
+        glTexImage2D(GL_TEXTURE_2D, (GLint)normalMips.size(), GL_RG16_SNORM, dst.x, dst.y, 0, GL_RG, GL_SHORT,
+            normalMips.back().data());
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)normalMips.size());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+inline void TerrainInstancer::downsampleNormals(const int16_t* src, int srcX0, int srcZ0, int srcStride,
+    const glm::ivec2& srcSize, int16_t* dst, int dstStride, int i0, int j0, int i1, int j1)
+{
+    // 某一维只剩 1 个 texel 时，第二个样本退回同一行 / 列
+    ThreadPool::shared().parallelFor(j0, j1 + 1, [&](int j) {
+        const int z0 = 2 * j - srcZ0;
+        const int z1 = std::min(2 * j + 1, srcSize.y - 1) - srcZ0;
+        const int16_t* r0 = src + (size_t)z0 * srcStride * 2;
+        const int16_t* r1 = src + (size_t)z1 * srcStride * 2;
+        int16_t* out = dst + (size_t)j * dstStride * 2;
+        for (int i = i0; i <= i1; ++i) {
+            const int x0 = (2 * i - srcX0) * 2;
+            const int x1 = (std::min(2 * i + 1, srcSize.x - 1) - srcX0) * 2;
+            for (int c = 0; c < 2; ++c) {
+                int sum = r0[x0 + c] + r0[x1 + c] + r1[x0 + c] + r1[x1 + c];
+                out[i * 2 + c] = (int16_t)((sum + 2) >> 2);
+            }
+        }
+    }, 16);
+}
+
+inline void TerrainInstancer::updateRegion(const Heightmap& heightmap, const TerrainNormalField& normals, int x0, int z0, int x1, int z1) {
+    if (VAO == 0) return;
+
+    // 高度：直接从带填充的采样区按行跨度上传
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, heightmap.rowStride());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, z0, x1 - x0 + 1, z1 - z0 + 1,
+        GL_RED, GL_UNSIGNED_SHORT, heightmap.row(z0) + x0);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // 法线：中央差分会波及矩形外一圈，直接从法线场按行跨度上传这一块
+    const int fieldW = normals.getWidth();
+    int nx0 = std::max(x0 - 1, 0), nz0 = std::max(z0 - 1, 0);
+    int nx1 = std::min(x1 + 1, fieldW - 1), nz1 = std::min(z1 + 1, normals.getHeight() - 1);
+
+    glBindTexture(GL_TEXTURE_2D, normalTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, fieldW);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, nx0, nz0, nx1 - nx0 + 1, nz1 - nz0 + 1, GL_RG, GL_SHORT, normals.at(nx0, nz0));
+
+    // 逐层：受影响的 texel 区间减半，从上一层（第 0 层即法线场本身）求平均后只上传这一块
+    int i0 = nx0, j0 = nz0, i1 = nx1, j1 = nz1;
+    for (size_t l = 1; l < mipSizes.size(); ++l) {
+        i0 >>= 1; j0 >>= 1;
+        i1 = std::min(i1 >> 1, mipSizes[l].x - 1);
+        j1 = std::min(j1 >> 1, mipSizes[l].y - 1);
+        if (i0 > i1 || j0 > j1) break; // 只改到了奇数尺寸层多出的最后一行 / 列，不影响更粗的层
+
+        std::vector<int16_t>& level = normalMips[l - 1];
+        if (l == 1) {
+            downsampleNormals(normals.data(), 0, 0, fieldW, mipSizes[0], level.data(), mipSizes[1].x, i0, j0, i1, j1);
+        }
+        else {
+            downsampleNormals(normalMips[l - 2].data(), 0, 0, mipSizes[l - 1].x, mipSizes[l - 1],
+                level.data(), mipSizes[l].x, i0, j0, i1, j1);
+        }
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, mipSizes[l].x);
+        glTexSubImage2D(GL_TEXTURE_2D, (GLint)l, i0, j0, i1 - i0 + 1, j1 - j0 + 1, GL_RG, GL_SHORT,
+            level.data() + ((size_t)j0 * mipSizes[l].x + i0) * 2);
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+inline void TerrainInstancer::release() {
+    if (VAO != 0) {
+        glDeleteVertexArrays(1, &VAO);
+        glDeleteBuffers(1, &instanceVBO);
+        VAO = 0;
+        instanceVBO = 0;
+    }
+    if (heightTexture != 0) glDeleteTextures(1, &heightTexture);
+    if (normalTexture != 0) glDeleteTextures(1, &normalTexture);
+    heightTexture = 0;
+    normalTexture = 0;
+    mipSizes.clear();
+    std::vector<std::vector<int16_t>>().swap(normalMips);
+}
+
+inline void TerrainInstancer::begin() {
+    for (auto& group : groups) group.instances.clear();
+}
+
+inline void TerrainInstancer::add(int chunkIndex, int lod, int variant, const TerrainIndexRange& range) {
+    lod = TerrainIndexBuffer::clampLOD(lod);
+    Group& group = groups[lod * TerrainIndexBuffer::STITCH_MASK_COUNT + (variant & (TerrainIndexBuffer::STITCH_MASK_COUNT - 1))];
+    group.range = range;
+    group.instances.push_back({
+        (int16_t)(chunkIndex % chunkCountX),
+        (int16_t)(chunkIndex / chunkCountX),
+        (int16_t)lod,
+        0
+    });
+}
+
+inline void TerrainInstancer::flush() {
+    drawCount = 0;
+    if (VAO == 0) return;
+
+    // 按分组拼接，一次上传（先孤立旧存储，避免与上一帧的绘制同步）
+    staging.clear();
+    for (const auto& group : groups) {
+        staging.insert(staging.end(), group.instances.begin(), group.instances.end());
+    }
+    if (staging.empty()) return;
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)capacity * sizeof(TerrainInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, staging.size() * sizeof(TerrainInstance), staging.data());
+
+    size_t first = 0;
+    for (const auto& group : groups) {
+        if (group.instances.empty()) continue;
+
+        // 没有 baseInstance：把实例属性指到该分组的起点
+        glVertexAttribIPointer(2, 4, GL_SHORT, sizeof(TerrainInstance), (void*)(first * sizeof(TerrainInstance)));
+        glDrawElementsInstanced(
+            GL_TRIANGLES,
+            group.range.count,
+            GL_UNSIGNED_SHORT,
+            (const void*)group.range.offset,
+            (GLsizei)group.instances.size()
+        );
+
+        first += group.instances.size();
+        ++drawCount;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+inline void TerrainInstancer::flushPatches(int patchVertices) {
+    drawCount = 0;
+    if (VAO == 0) return;
+
+    staging.clear();
+    for (const auto& group : groups) {
+        staging.insert(staging.end(), group.instances.begin(), group.instances.end());
+    }
+    if (staging.empty()) return;
+
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)capacity * sizeof(TerrainInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, staging.size() * sizeof(TerrainInstance), staging.data());
+    glVertexAttribIPointer(2, 4, GL_SHORT, sizeof(TerrainInstance), (void*)0);
+
+    glPatchParameteri(GL_PATCH_VERTICES, 4);
+    glDrawArraysInstanced(GL_PATCHES, 0, patchVertices, (GLsizei)staging.size());
+    drawCount = 1;
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+inline void TerrainInstancer::bindTextures() const {
+    glActiveTexture(GL_TEXTURE0 + TERRAIN_HEIGHT_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, heightTexture);
+    glActiveTexture(GL_TEXTURE0 + TERRAIN_NORMAL_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, normalTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
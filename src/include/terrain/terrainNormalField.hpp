@@ -0,0 +1,173 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <glm/glm.hpp>
+#include "heightmap.hpp"
+#include "../threadPool.hpp"
+
+// 法线场编码的 SIMD 路径：AVX2 一次 8 个采样（连续加载，无 gather），否则逐点走标量
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TERRAIN_NORMAL_AVX2 1
+#endif
+
+// 单位法线 → 八面体编码（投影到 XZ 平面，y<0 的半球向外折叠）；n 不必归一化
+static inline void octEncodeNormal(const glm::vec3& n, int16_t out[2]) {
+    float inv = 1.0f / (std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z));
+    float px = n.x * inv;
+    float pz = n.z * inv;
+    if (n.y < 0.0f) {
+        float fx = (1.0f - std::fabs(pz)) * (px >= 0.0f ? 1.0f : -1.0f);
+        float fz = (1.0f - std::fabs(px)) * (pz >= 0.0f ? 1.0f : -1.0f);
+        px = fx;
+        pz = fz;
+    }
+    out[0] = (int16_t)std::lround(glm::clamp(px, -1.0f, 1.0f) * 32767.0f);
+    out[1] = (int16_t)std::lround(glm::clamp(pz, -1.0f, 1.0f) * 32767.0f);
+}
+
+// 八面体编码 → 单位法线（与 terrain.vs 的 octDecode 相同）
+static inline glm::vec3 octDecodeNormal(const int16_t in[2]) {
+    float px = std::max(in[0] / 32767.0f, -1.0f);
+    float pz = std::max(in[1] / 32767.0f, -1.0f);
+    glm::vec3 n(px, 1.0f - std::fabs(px) - std::fabs(pz), pz);
+    if (n.y < 0.0f) {
+        n.x = (1.0f - std::fabs(pz)) * (px >= 0.0f ? 1.0f : -1.0f);
+        n.z = (1.0f - std::fabs(px)) * (pz >= 0.0f ? 1.0f : -1.0f);
+    }
+    return glm::normalize(n);
+}
+
+// ====================== TerrainNormalField ======================
+// 全分辨率法线场：加载时对整张 heightmap 做一遍中央差分，八面体编码为 2 x int16（每采样 4 字节），
+// 按行并行、行内 AVX2 一次 8 个采样。chunk 构建（边界顶点不再被相邻 chunk 各算一遍）、
+// 实例化模式的法线纹理与运行时的法线查询都直接读这一份。
+// 地形编辑后只重算被修改矩形外扩一圈的部分。
+// ================================================================
+class TerrainNormalField {
+public:
+    // 由 heightmap 计算整张法线场（heightmap 须比本对象活得久）
+    void build(const Heightmap& heightmap, float gridScale);
+
+    // heightmap 采样矩形 [x0, x1] x [z0, z1] 被修改后，重算受影响的法线（外扩一圈）
+    void update(int x0, int z0, int x1, int z1);
+
+    // 采样 (x, z) 的编码法线（x ∈ [0, width)，z ∈ [0, height)）
+    const int16_t* at(int x, int z) const { return &encoded[((size_t)z * width + x) * 2]; }
+    glm::vec3 decode(int x, int z) const { return octDecodeNormal(at(x, z)); }
+
+    // 整张场（行优先，行跨度 width，每采样 2 个分量），供纹理上传
+    const int16_t* data() const { return encoded.data(); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    size_t memoryBytes() const { return encoded.size() * sizeof(int16_t); }
+
+private:
+    // 编码第 z 行的 [x0, x1]
+    void encodeRow(int z, int x0, int x1);
+
+private:
+    const Heightmap* heightmap = nullptr;
+    float gridScale = 1.0f;
+    int width = 0;
+    int height = 0;
+    std::vector<int16_t> encoded;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainNormalField::build(const Heightmap& inHeightmap, float inGridScale) {
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+
+    heightmap = &inHeightmap;
+    gridScale = inGridScale;
+    width = heightmap->width;
+    height = heightmap->height;
+    encoded.assign((size_t)width * height * 2, 0);
+
+    ThreadPool::shared().parallelFor(0, height, [this](int z) {
+        encodeRow(z, 0, width - 1);
+    }, 16);
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "[Terrain] Normal field " << width << "x" << height << " ("
+        << (memoryBytes() >> 10) << " KB) in " << ms << " ms" << std::endl;
+}
+
+inline void TerrainNormalField::update(int x0, int z0, int x1, int z1) {
+    if (!heightmap) return;
+
+    x0 = std::max(x0 - 1, 0); z0 = std::max(z0 - 1, 0);
+    x1 = std::min(x1 + 1, width - 1); z1 = std::min(z1 + 1, height - 1);
+    if (x0 > x1 || z0 > z1) return;
+
+    ThreadPool::shared().parallelFor(z0, z1 + 1, [&](int z) {
+        encodeRow(z, x0, x1);
+    }, 16);
+}
+
+inline void TerrainNormalField::encodeRow(int z, int x0, int x1) {
+    // 与 chunk 原先逐顶点的法线计算相同：n = (h(x-1) - h(x+1), 2 * gridScale, h(z-1) - h(z+1))，
+    // 邻居落在 heightmap 的边缘填充上，无需 clamp
+    const unsigned short* r = heightmap->row(z);
+    const unsigned short* up = heightmap->row(z - 1);
+    const unsigned short* down = heightmap->row(z + 1);
+    const float toHeight = heightmap->sampleToHeight();
+    const float ny = 2.0f * gridScale;
+    int16_t* out = &encoded[(size_t)z * width * 2];
+
+    int x = x0;
+#if defined(TERRAIN_NORMAL_AVX2)
+    // ny > 0，编码永远不需要折叠：p = n / |n|_1，再按 lround 的“远离零取整”量化；
+    // 运算顺序与标量 octEncodeNormal 一致，两条路径逐位相同
+    const __m256 vToHeight = _mm256_set1_ps(toHeight);
+    const __m256 vNy = _mm256_set1_ps(ny);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 minusOne = _mm256_set1_ps(-1.0f);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 scale = _mm256_set1_ps(32767.0f);
+    const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+    const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000u));
+    const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+
+    auto quantize = [&](__m256 p) {
+        __m256 s = _mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(p, minusOne), one), scale);
+        __m256 t = _mm256_round_ps(s, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+        __m256 frac = _mm256_and_ps(_mm256_sub_ps(s, t), absMask);
+        __m256 step = _mm256_or_ps(one, _mm256_and_ps(s, signMask));
+        t = _mm256_add_ps(t, _mm256_and_ps(_mm256_cmp_ps(frac, half, _CMP_GE_OQ), step));
+        return _mm256_cvttps_epi32(t);
+    };
+
+    for (; x + 8 <= x1 + 1; x += 8) {
+        __m256i left = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(r + x - 1)));
+        __m256i right = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(r + x + 1)));
+        __m256i above = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(up + x)));
+        __m256i below = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(down + x)));
+
+        __m256 dx = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(left, right)), vToHeight);
+        __m256 dz = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(above, below)), vToHeight);
+
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_and_ps(dx, absMask), vNy), _mm256_and_ps(dz, absMask));
+        __m256 inv = _mm256_div_ps(one, sum);
+        __m256i px = quantize(_mm256_mul_ps(dx, inv));
+        __m256i pz = quantize(_mm256_mul_ps(dz, inv));
+
+        // 每个 32 位字 = (px, pz) 两个 int16（小端）
+        __m256i packed = _mm256_or_si256(_mm256_and_si256(px, lowMask), _mm256_slli_epi32(pz, 16));
+        _mm256_storeu_si256((__m256i*)(out + x * 2), packed);
+    }
+#endif
+    for (; x <= x1; ++x) {
+        glm::vec3 n(
+            ((int)r[x - 1] - (int)r[x + 1]) * toHeight,
+            ny,
+            ((int)up[x] - (int)down[x]) * toHeight);
+        octEncodeNormal(n, out + x * 2);
+    }
+}
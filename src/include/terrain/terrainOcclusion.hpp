@@ -0,0 +1,188 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+#include <glm/glm.hpp>
+#include "frustumCulling.hpp"
+
+// 每帧的地平线遮挡统计
+struct TerrainOcclusionStats {
+    int tested = 0;     // 参与测试的 chunk 数（视锥裁剪之后）
+    int occluded = 0;   // 被地平线遮挡而跳过的 chunk 数
+};
+
+// ====================== TerrainHorizonCuller ======================
+// CPU 地平线遮挡：以相机为中心把方位角分成 COLUMN_COUNT 列，每列记录一条“仰角地平线”
+// （仰角用斜率 (y - eyeY) / 水平距离 表示），由近到远处理 chunk：
+//   - chunk 顶面（AABB maxY）在其覆盖的每一列上都低于地平线 → 被山脊挡住，跳过
+//   - 否则保留，并把它作为遮挡体抬高它完全覆盖的那些列
+// 保守性：
+//   - 相机在地面之上时，任何穿过“chunk 足迹 x (-inf, groundMinY]”棱柱的视线，都必须先穿过地表；
+//     因此遮挡体只写入它对整列都成立的下界仰角，且只写入完全被其方位角区间覆盖的列
+//   - 遮挡体先挂起，直到后续 chunk 的最近水平距离不小于它的最远水平距离时才写入地平线，
+//     保证写入地平线的遮挡体一定整体位于被测 chunk 之前
+//   - 方位角列与相机俯仰 / 翻滚无关，不会因为屏幕列的透视变形而误剔
+// ===================================================================
+class TerrainHorizonCuller {
+public:
+    static constexpr int COLUMN_COUNT = 2048;
+
+    // 从 chunks（chunk 下标，视锥裁剪结果）中移除被遮挡的 chunk，剩余按由近到远排列
+    // bounds 为各 chunk 的 AABB（被测）；ground 为各 chunk 的精确足迹（x/z，不含防闪烁外扩），
+    // 其 min.y 为地表最低高度（不含 skirt，用作遮挡体）
+    void cull(const glm::vec3& eye,
+        const std::vector<AABB>& bounds,
+        const std::vector<AABB>& ground,
+        std::vector<int>& chunks);
+
+    const TerrainOcclusionStats& getStats() const { return stats; }
+
+private:
+    struct Candidate {
+        int chunk;
+        float nearDist;     // 相机到足迹的最近水平距离
+        float farDist;      // 相机到足迹的最远水平距离
+    };
+
+    // 足迹的方位角区间（以列为单位，u1 - u0 < COLUMN_COUNT / 2）；相机在足迹内返回 false
+    bool columnSpan(const glm::vec3& eye, const AABB& box, float& u0, float& u1) const;
+    bool isOccluded(const glm::vec3& eye, const AABB& box, const Candidate& c) const;
+    void addOccluder(const glm::vec3& eye, const AABB& ground, const Candidate& c);
+
+private:
+    std::vector<float> horizon;             // 每列：低于该仰角的视线必定先碰到地表
+    std::vector<Candidate> order;           // 每帧复用
+    std::vector<std::pair<float, int>> pending; // 挂起的遮挡体（最远距离, order 下标），小顶堆
+    TerrainOcclusionStats stats;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainHorizonCuller::cull(const glm::vec3& eye,
+    const std::vector<AABB>& bounds,
+    const std::vector<AABB>& ground,
+    std::vector<int>& chunks)
+{
+    stats.tested = (int)chunks.size();
+    stats.occluded = 0;
+    if (chunks.empty()) return;
+
+    // 1. 计算水平距离区间并由近到远排序
+    order.clear();
+    order.reserve(chunks.size());
+    for (int i : chunks) {
+        const AABB& b = bounds[i];
+        float dx = std::max({ b.min.x - eye.x, 0.0f, eye.x - b.max.x });
+        float dz = std::max({ b.min.z - eye.z, 0.0f, eye.z - b.max.z });
+        float fx = std::max(eye.x - b.min.x, b.max.x - eye.x);
+        float fz = std::max(eye.z - b.min.z, b.max.z - eye.z);
+        order.push_back({ i, std::sqrt(dx * dx + dz * dz), std::sqrt(fx * fx + fz * fz) });
+    }
+    std::sort(order.begin(), order.end(), [](const Candidate& a, const Candidate& b) {
+        return a.nearDist < b.nearDist;
+    });
+
+    horizon.assign(COLUMN_COUNT, -std::numeric_limits<float>::infinity());
+    pending.clear();
+    chunks.clear();
+
+    // 2. 由近到远：先把已完全位于当前 chunk 之前的遮挡体写入地平线，再测试
+    for (int k = 0; k < (int)order.size(); ++k) {
+        const Candidate& c = order[k];
+
+        while (!pending.empty() && pending.front().first <= c.nearDist) {
+            const Candidate& o = order[pending.front().second];
+            addOccluder(eye, ground[o.chunk], o);
+            std::pop_heap(pending.begin(), pending.end(), std::greater<std::pair<float, int>>());
+            pending.pop_back();
+        }
+
+        if (isOccluded(eye, bounds[c.chunk], c)) {
+            ++stats.occluded;
+            continue;
+        }
+
+        chunks.push_back(c.chunk);
+        pending.emplace_back(c.farDist, k);
+        std::push_heap(pending.begin(), pending.end(), std::greater<std::pair<float, int>>());
+    }
+}
+
+inline bool TerrainHorizonCuller::columnSpan(const glm::vec3& eye, const AABB& box, float& u0, float& u1) const {
+    if (eye.x >= box.min.x && eye.x <= box.max.x && eye.z >= box.min.z && eye.z <= box.max.z) return false;
+
+    const float twoPi = 6.28318530718f;
+    const float pi = 3.14159265359f;
+
+    // 以中心方向为基准取四个角的相对方位角；相机在足迹外时区间宽度 < pi，不会跨越 ±pi
+    float center = std::atan2(0.5f * (box.min.z + box.max.z) - eye.z, 0.5f * (box.min.x + box.max.x) - eye.x);
+    float lo = 0.0f, hi = 0.0f;
+    const float xs[2] = { box.min.x, box.max.x };
+    const float zs[2] = { box.min.z, box.max.z };
+    for (float x : xs) {
+        for (float z : zs) {
+            float a = std::atan2(z - eye.z, x - eye.x) - center;
+            if (a > pi) a -= twoPi;
+            if (a < -pi) a += twoPi;
+            lo = std::min(lo, a);
+            hi = std::max(hi, a);
+        }
+    }
+
+    const float toColumn = COLUMN_COUNT / twoPi;
+    u0 = (center + lo) * toColumn;
+    u1 = (center + hi) * toColumn;
+    return true;
+}
+
+inline bool TerrainHorizonCuller::isOccluded(const glm::vec3& eye, const AABB& box, const Candidate& c) const {
+    float u0, u1;
+    if (!columnSpan(eye, box, u0, u1)) return false;
+
+    // 顶面在整个足迹上的最大仰角（高于相机时取最近距离，低于相机时取最远距离）
+    float top = box.max.y - eye.y;
+    if (top >= 0.0f && c.nearDist <= 1e-3f) return false;
+    float elevation = (top >= 0.0f) ? top / c.nearDist : top / c.farDist;
+
+    // 与方位角区间有交的每一列都必须挡住它
+    int first = (int)std::floor(u0);
+    int last = (int)std::floor(u1);
+    for (int col = first; col <= last; ++col) {
+        int k = ((col % COLUMN_COUNT) + COLUMN_COUNT) % COLUMN_COUNT;
+        if (!(elevation < horizon[k])) return false;
+    }
+    return true;
+}
+
+inline void TerrainHorizonCuller::addOccluder(const glm::vec3& eye, const AABB& box, const Candidate& c) {
+    // 视线穿出足迹的点一定落在“背向相机”的边上：到这些边的最近距离是穿出距离的下界
+    auto segmentDist = [](float along, float lo, float hi, float across) {
+        float d = std::max({ lo - along, 0.0f, along - hi });
+        return std::sqrt(d * d + across * across);
+        };
+    float backDist = std::numeric_limits<float>::infinity();
+    if (eye.x > box.min.x) backDist = std::min(backDist, segmentDist(eye.z, box.min.z, box.max.z, eye.x - box.min.x));
+    if (eye.x < box.max.x) backDist = std::min(backDist, segmentDist(eye.z, box.min.z, box.max.z, box.max.x - eye.x));
+    if (eye.z > box.min.z) backDist = std::min(backDist, segmentDist(eye.x, box.min.x, box.max.x, eye.z - box.min.z));
+    if (eye.z < box.max.z) backDist = std::min(backDist, segmentDist(eye.x, box.min.x, box.max.x, box.max.z - eye.z));
+    if (backDist <= 1e-3f) return;
+
+    // 穿过足迹的视线中，仰角不超过该值的都会在足迹内低于最低地表，即必先碰到地表
+    // （c.farDist 按外扩后的 AABB 计算，不小于足迹的真实最远距离，仍然保守）
+    float ground = box.min.y - eye.y;
+    float elevation = (ground >= 0.0f) ? ground / c.farDist : ground / backDist;
+
+    // 只写入被方位角区间完全覆盖的列；相机在足迹内时覆盖全部列
+    int first = 0, last = COLUMN_COUNT - 1;
+    float u0, u1;
+    if (columnSpan(eye, box, u0, u1)) {
+        first = (int)std::ceil(u0);
+        last = (int)std::floor(u1) - 1;
+    }
+    for (int col = first; col <= last; ++col) {
+        int k = ((col % COLUMN_COUNT) + COLUMN_COUNT) % COLUMN_COUNT;
+        horizon[k] = std::max(horizon[k], elevation);
+    }
+}
@@ -0,0 +1,386 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <glm/glm.hpp>
+
+#include "terrainChunk.hpp"
+#include "terrainIndexBuffer.hpp"
+#include "terrainBatch.hpp"
+#include "../threadPool.hpp"
+
+// terrain.vs 中 uSlotChunks（槽位 -> chunk 下标）使用的纹理单元，避开 0~2 的地表贴图
+static constexpr int TERRAIN_SLOT_TEXTURE_UNIT = 3;
+
+// 分页参数
+struct TerrainPagerSettings {
+    float residentRadius = 1000.0f;   // 常驻半径（XZ 平面，世界单位）
+    int memoryBudgetMB = 32;          // 顶点显存预算
+    int maxUploadsPerFrame = 8;       // 每帧最多上传的 chunk 数
+    int maxBuildsInFlight = 32;       // 同时在后台构建的 chunk 数上限
+};
+
+// ====================== TerrainPager ======================
+// 分页模式：只有相机附近 residentRadius 内的 chunk 常驻 GPU。
+//   - 后台：ThreadPool 构建相机附近尚未加载的 chunk（由近到远）
+//   - 主线程：每帧最多上传 maxUploadsPerFrame 个已完成的 chunk，上传后立即释放 CPU 顶点
+//   - 显存：固定大小的槽位池（memoryBudgetMB 决定槽位数），槽位不足时淘汰最远的常驻 chunk
+// 槽位 s 占据大 VBO 的 [s*V, (s+1)*V)，terrain.vs 通过 uSlotChunks 查出该槽位对应的 chunk，
+// 从而重建世界坐标。所有 chunk 的 bounds 常驻，裁剪仍然走完整的四叉树。
+// ==========================================================
+class TerrainPager {
+public:
+    TerrainPager(
+        std::vector<TerrainChunk>& chunks,
+        int chunkCountX,
+        int chunkCountZ,
+        int chunkSize,
+        float gridScale,
+        const TerrainIndexBuffer& indices,
+        const TerrainPagerSettings& settings = TerrainPagerSettings()
+    );
+    ~TerrainPager();
+
+    TerrainPager(const TerrainPager&) = delete;
+    TerrainPager& operator=(const TerrainPager&) = delete;
+
+    // 每帧调用（主线程）：调度后台构建、限量上传、按需淘汰
+    void update(const glm::vec3& cameraPos);
+
+    // 等待所有已提交的后台构建结束（结果留到下一次 update 处理）
+    void waitIdle();
+
+    // heightmap 被修改（须先 waitIdle）：尚未上传的构建结果作废，之后按新高度重建；
+    // 返回该 chunk 是否常驻 —— 常驻的由调用者重建顶点后调用 reupload，期间旧数据照常绘制
+    bool invalidate(int chunkIndex);
+    // 把重新 build 过的常驻 chunk 写回它的槽位，并释放 CPU 顶点
+    void reupload(int chunkIndex);
+
+    // chunk 当前所在槽位，未驻留返回 -1
+    int slotOf(int chunkIndex) const { return chunkSlot[chunkIndex]; }
+
+    // 槽位化的大 VBO（绘制时 batch.add 传入槽位而不是 chunk 下标）
+    TerrainBatch& getBatch() { return batch; }
+
+    // 绑定槽位 -> chunk 查找表
+    void bindSlotTexture(int unit) const;
+
+    int getSlotCount() const { return (int)slotChunk.size(); }
+    int getResidentCount() const { return residentCount; }
+
+private:
+    enum class State : uint8_t {
+        Unloaded,   // 只有 bounds
+        Building,   // 已提交给线程池
+        Ready,      // CPU 顶点已就绪，等待上传
+        Resident    // 已上传到某个槽位
+    };
+
+    float distanceTo(int chunkIndex, const glm::vec3& cameraPos) const;
+
+    void collectCompleted(const glm::vec3& cameraPos);
+    void scheduleBuilds(const glm::vec3& cameraPos);
+    void uploadReady(const glm::vec3& cameraPos);
+
+    // 取得一个槽位：优先空闲槽位，否则淘汰比 distance 更远的最远常驻 chunk；失败返回 -1
+    int acquireSlot(float distance, const glm::vec3& cameraPos);
+    void evict(int chunkIndex);
+
+private:
+    std::vector<TerrainChunk>& chunks;
+    int chunkCountX;
+    int chunkCountZ;
+    float chunkWorldSize;
+    float halfExtentX;
+    float halfExtentZ;
+    TerrainPagerSettings settings;
+
+    // 以下状态只在主线程读写
+    std::vector<State> state;
+    std::vector<int> chunkSlot;     // chunk -> 槽位
+    std::vector<char> stale;        // 构建期间 heightmap 被修改，完成后丢弃
+    std::vector<int> slotChunk;     // 槽位 -> chunk（-1 表示空闲）
+    std::vector<int> freeSlots;
+    std::vector<int> readyChunks;   // 已构建完成、等待上传
+    std::vector<int> candidates;    // 每帧复用
+    int residentCount = 0;
+
+    // 工作线程 -> 主线程的完成队列
+    std::mutex doneMutex;
+    std::condition_variable doneCv;
+    std::vector<int> done;
+    std::vector<int> drained;
+    int inFlight = 0;               // 受 doneMutex 保护
+    std::atomic<bool> stopping{ false };
+
+    TerrainBatch batch;
+    unsigned int slotBuffer = 0;    // GL_TEXTURE_BUFFER 的数据（R32I）
+    unsigned int slotTexture = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline TerrainPager::TerrainPager(
+    std::vector<TerrainChunk>& chunks,
+    int chunkCountX,
+    int chunkCountZ,
+    int chunkSize,
+    float gridScale,
+    const TerrainIndexBuffer& indices,
+    const TerrainPagerSettings& settings
+)
+    : chunks(chunks), chunkCountX(chunkCountX), chunkCountZ(chunkCountZ),
+    chunkWorldSize((chunkSize - 1) * gridScale),
+    halfExtentX(chunkCountX * (chunkSize - 1) * gridScale * 0.5f),
+    halfExtentZ(chunkCountZ * (chunkSize - 1) * gridScale * 0.5f),
+    settings(settings)
+{
+    const int total = (int)chunks.size();
+    const int vertsPerChunk = TerrainIndexBuffer::vertexCount(chunkSize);
+
+    // 预算 -> 槽位数（不超过 chunk 总数）
+    size_t slotBytes = (size_t)vertsPerChunk * sizeof(TerrainVertex);
+    int slotCount = (int)(((size_t)settings.memoryBudgetMB << 20) / slotBytes);
+    slotCount = std::max(1, std::min(slotCount, total));
+
+    state.assign(total, State::Unloaded);
+    chunkSlot.assign(total, -1);
+    stale.assign(total, 0);
+    slotChunk.assign(slotCount, -1);
+    freeSlots.reserve(slotCount);
+    for (int s = slotCount - 1; s >= 0; --s) freeSlots.push_back(s);
+
+    batch.allocate(slotCount, vertsPerChunk, indices);
+
+    // 槽位 -> chunk 查找表
+    std::vector<int> initial(slotCount, 0);
+    glGenBuffers(1, &slotBuffer);
+    glBindBuffer(GL_TEXTURE_BUFFER, slotBuffer);
+    glBufferData(GL_TEXTURE_BUFFER, slotCount * sizeof(int), initial.data(), GL_DYNAMIC_DRAW);
+    glGenTextures(1, &slotTexture);
+    glBindTexture(GL_TEXTURE_BUFFER, slotTexture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, slotBuffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+    glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    std::cout << "[Terrain] Paging: " << slotCount << " resident slots ("
+        << (slotBytes * slotCount >> 20) << " MB), radius " << settings.residentRadius << std::endl;
+}
+
+inline TerrainPager::~TerrainPager() {
+    // 未开始的任务直接跳过；已开始的等它做完，避免访问已析构的对象
+    stopping = true;
+    waitIdle();
+
+    if (slotTexture != 0) glDeleteTextures(1, &slotTexture);
+    if (slotBuffer != 0) glDeleteBuffers(1, &slotBuffer);
+}
+
+inline void TerrainPager::waitIdle() {
+    std::unique_lock<std::mutex> lock(doneMutex);
+    doneCv.wait(lock, [this] { return inFlight == 0; });
+}
+
+inline bool TerrainPager::invalidate(int chunkIndex) {
+    switch (state[chunkIndex]) {
+    case State::Building:
+        stale[chunkIndex] = 1;
+        return false;
+    case State::Ready:
+        chunks[chunkIndex].releaseVertices();
+        state[chunkIndex] = State::Unloaded;
+        readyChunks.erase(std::find(readyChunks.begin(), readyChunks.end(), chunkIndex));
+        return false;
+    case State::Resident:
+        return true;
+    default:
+        return false;
+    }
+}
+
+inline void TerrainPager::reupload(int chunkIndex) {
+    int slot = chunkSlot[chunkIndex];
+    if (slot >= 0) batch.upload(slot, chunks[chunkIndex]);
+    chunks[chunkIndex].releaseVertices();
+}
+
+inline void TerrainPager::bindSlotTexture(int unit) const {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_BUFFER, slotTexture);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+inline float TerrainPager::distanceTo(int chunkIndex, const glm::vec3& cameraPos) const {
+    glm::vec3 c = chunks[chunkIndex].getCenter();
+    return glm::length(glm::vec2(c.x - cameraPos.x, c.z - cameraPos.z));
+}
+
+inline void TerrainPager::update(const glm::vec3& cameraPos) {
+    collectCompleted(cameraPos);
+    uploadReady(cameraPos);
+    scheduleBuilds(cameraPos);
+}
+
+inline void TerrainPager::collectCompleted(const glm::vec3& cameraPos) {
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        drained.swap(done);
+    }
+
+    for (int i : drained) {
+        // 构建期间相机已走远或高度已被修改：直接丢弃（后者下一轮按新高度重建）
+        if (stale[i] || distanceTo(i, cameraPos) > settings.residentRadius) {
+            stale[i] = 0;
+            chunks[i].releaseVertices();
+            state[i] = State::Unloaded;
+            continue;
+        }
+        state[i] = State::Ready;
+        readyChunks.push_back(i);
+    }
+    drained.clear();
+}
+
+inline void TerrainPager::uploadReady(const glm::vec3& cameraPos) {
+    if (readyChunks.empty()) return;
+
+    // 由近到远上传；超出本帧配额的留到下一帧
+    std::sort(readyChunks.begin(), readyChunks.end(), [&](int a, int b) {
+        return distanceTo(a, cameraPos) < distanceTo(b, cameraPos);
+    });
+
+    int uploads = 0;
+    size_t keep = 0;
+    for (size_t k = 0; k < readyChunks.size(); ++k) {
+        int i = readyChunks[k];
+        float d = distanceTo(i, cameraPos);
+
+        if (d > settings.residentRadius) {
+            chunks[i].releaseVertices();
+            state[i] = State::Unloaded;
+            continue;
+        }
+        if (uploads >= settings.maxUploadsPerFrame) {
+            readyChunks[keep++] = i;
+            continue;
+        }
+
+        int slot = acquireSlot(d, cameraPos);
+        if (slot < 0) {
+            // 预算已满且所有常驻 chunk 都更近：放弃，等相机移动后再重建
+            chunks[i].releaseVertices();
+            state[i] = State::Unloaded;
+            continue;
+        }
+
+        batch.upload(slot, chunks[i]);
+        glBindBuffer(GL_TEXTURE_BUFFER, slotBuffer);
+        glBufferSubData(GL_TEXTURE_BUFFER, slot * sizeof(int), sizeof(int), &i);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+        chunks[i].releaseVertices();
+        slotChunk[slot] = i;
+        chunkSlot[i] = slot;
+        state[i] = State::Resident;
+        ++residentCount;
+        ++uploads;
+    }
+    readyChunks.resize(keep);
+}
+
+inline void TerrainPager::scheduleBuilds(const glm::vec3& cameraPos) {
+    int inFlightNow;
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        inFlightNow = inFlight;
+    }
+    // 待上传的也计入，避免后台构建远快于上传时 CPU 顶点堆积
+    int budget = settings.maxBuildsInFlight - inFlightNow - (int)readyChunks.size();
+    if (budget <= 0) return;
+
+    // 只遍历半径覆盖的 chunk 窗口
+    const float r = settings.residentRadius;
+    int x0 = std::max(0, (int)std::floor((cameraPos.x - r + halfExtentX) / chunkWorldSize));
+    int x1 = std::min(chunkCountX - 1, (int)std::floor((cameraPos.x + r + halfExtentX) / chunkWorldSize));
+    int z0 = std::max(0, (int)std::floor((cameraPos.z - r + halfExtentZ) / chunkWorldSize));
+    int z1 = std::min(chunkCountZ - 1, (int)std::floor((cameraPos.z + r + halfExtentZ) / chunkWorldSize));
+
+    candidates.clear();
+    for (int z = z0; z <= z1; ++z) {
+        for (int x = x0; x <= x1; ++x) {
+            int i = z * chunkCountX + x;
+            if (state[i] == State::Unloaded && distanceTo(i, cameraPos) <= r) candidates.push_back(i);
+        }
+    }
+    if (candidates.empty()) return;
+
+    // 最近的优先
+    if ((int)candidates.size() > budget) {
+        std::nth_element(candidates.begin(), candidates.begin() + budget, candidates.end(), [&](int a, int b) {
+            return distanceTo(a, cameraPos) < distanceTo(b, cameraPos);
+        });
+        candidates.resize(budget);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        inFlight += (int)candidates.size();
+    }
+
+    ThreadPool& pool = ThreadPool::shared();
+    for (int i : candidates) {
+        state[i] = State::Building;
+        pool.submit([this, i] {
+            // 只生成顶点：bounds / LOD 误差归主线程所有（初始化时算好，编辑后由 TerrainSystem 重算）
+            if (!stopping) chunks[i].buildGeometry();
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                done.push_back(i);
+                --inFlight;
+            }
+            doneCv.notify_all();
+        });
+    }
+}
+
+inline int TerrainPager::acquireSlot(float distance, const glm::vec3& cameraPos) {
+    if (!freeSlots.empty()) {
+        int slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    // 找最远的常驻 chunk
+    int farthest = -1;
+    float farthestDistance = distance;
+    for (int chunk : slotChunk) {
+        if (chunk < 0) continue;
+        float d = distanceTo(chunk, cameraPos);
+        if (d > farthestDistance) {
+            farthestDistance = d;
+            farthest = chunk;
+        }
+    }
+    if (farthest < 0) return -1;
+
+    int slot = chunkSlot[farthest];
+    evict(farthest);
+    freeSlots.pop_back(); // evict 刚放回的就是这个槽位
+    return slot;
+}
+
+inline void TerrainPager::evict(int chunkIndex) {
+    int slot = chunkSlot[chunkIndex];
+    if (slot < 0) return;
+
+    // GPU 数据原地保留，槽位被覆盖前不会再被引用
+    slotChunk[slot] = -1;
+    chunkSlot[chunkIndex] = -1;
+    freeSlots.push_back(slot);
+    state[chunkIndex] = State::Unloaded;
+    --residentCount;
+}
@@ -0,0 +1,174 @@
+#pragma once
+#include <vector>
+#include <limits>
+#include <glm/glm.hpp>
+#include "frustumCulling.hpp"
+
+// ====================== TerrainQuadtree ======================
+// 建立在 chunk 网格上的 min/max 四叉树：每个节点的 AABB 是其覆盖的所有 chunk AABB 的并集。
+// 裁剪时：
+//   - 节点完全在视锥外 → 整棵子树丢弃
+//   - 节点完全在视锥内 → 子树下所有 chunk 直接接受，不再逐个测试
+//   - 相交 → 递归子节点（只测试仍跨越的平面）；子树足够小时改用 SIMD 批量测试其全部 chunk
+// 代价与可见区域规模相关，而不是与地图总 chunk 数相关。
+// =============================================================
+class TerrainQuadtree {
+public:
+    // 根据 chunk 网格及每个 chunk 的 AABB 构建（bounds 按 z * countX + x 排列）
+    void build(int chunkCountX, int chunkCountZ, const std::vector<AABB>& chunkBounds);
+
+    // 拓扑不变、部分 chunk 的 AABB 改变（地形编辑）时自底向上重算所有节点的 bounds，O(节点数)
+    void refit(const std::vector<AABB>& chunkBounds);
+
+    // 收集与视锥相交的 chunk 下标（追加到 out）
+    void collectVisible(const Frustum& frustum, std::vector<int>& out) const;
+
+    bool empty() const { return nodes.empty(); }
+
+private:
+    struct Node {
+        AABB bounds;
+        // 覆盖的 chunk 范围 [x0, x1) x [z0, z1)
+        int x0 = 0, z0 = 0, x1 = 0, z1 = 0;
+        // 子树叶子在 leafOrder / leafBounds 中的连续区间 [first, last)
+        int first = 0, last = 0;
+        // 子节点下标，-1 表示无（叶子四个都为 -1）
+        int children[4] = { -1, -1, -1, -1 };
+    };
+
+    int buildNode(int x0, int z0, int x1, int z1, const std::vector<AABB>& chunkBounds);
+    void collectNode(int nodeIndex, const Frustum& frustum, unsigned planeMask, std::vector<int>& out) const;
+    void acceptAll(const Node& node, std::vector<int>& out) const;
+
+    // 相交节点覆盖的 chunk 数不超过该值时，直接对其叶子做 SIMD 批量测试，不再递归
+    static constexpr int BATCH_LEAF_COUNT = 16;
+
+private:
+    std::vector<Node> nodes;
+
+    // 叶子按深度优先顺序排列，任意子树对应一段连续区间
+    std::vector<int> leafOrder;  // DFS 顺序 -> chunk 下标
+    AABBSoA leafBounds;          // 与 leafOrder 同序的 chunk AABB（SoA）
+    mutable std::vector<int> batchScratch;
+
+    int countX = 0;
+    int countZ = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline void TerrainQuadtree::build(int chunkCountX, int chunkCountZ, const std::vector<AABB>& chunkBounds) {
+    nodes.clear();
+    leafOrder.clear();
+    leafBounds.clear();
+    countX = chunkCountX;
+    countZ = chunkCountZ;
+    if (countX <= 0 || countZ <= 0) return;
+
+    // 满四叉树节点数约为叶子数的 4/3
+    nodes.reserve((size_t)countX * countZ * 4 / 3 + 1);
+    leafOrder.reserve((size_t)countX * countZ);
+    leafBounds.reserve((size_t)countX * countZ);
+    buildNode(0, 0, countX, countZ, chunkBounds);
+}
+
+inline int TerrainQuadtree::buildNode(int x0, int z0, int x1, int z1, const std::vector<AABB>& chunkBounds) {
+    int index = (int)nodes.size();
+    nodes.emplace_back();
+    nodes[index].x0 = x0; nodes[index].z0 = z0;
+    nodes[index].x1 = x1; nodes[index].z1 = z1;
+    nodes[index].first = (int)leafOrder.size();
+
+    AABB box;
+    box.min = glm::vec3(std::numeric_limits<float>::max());
+    box.max = glm::vec3(-std::numeric_limits<float>::max());
+
+    if (x1 - x0 == 1 && z1 - z0 == 1) {
+        // 叶子：单个 chunk
+        box = chunkBounds[z0 * countX + x0];
+        leafOrder.push_back(z0 * countX + x0);
+        leafBounds.push_back(box);
+    }
+    else {
+        // 两个轴各自二分；某轴只剩一列时不再切分（兼容非 2 的幂网格）
+        int xm = (x1 - x0 > 1) ? (x0 + x1) / 2 : x1;
+        int zm = (z1 - z0 > 1) ? (z0 + z1) / 2 : z1;
+
+        const int rx[3] = { x0, xm, x1 };
+        const int rz[3] = { z0, zm, z1 };
+
+        int c = 0;
+        for (int j = 0; j < 2; ++j) {
+            for (int i = 0; i < 2; ++i) {
+                if (rx[i] == rx[i + 1] || rz[j] == rz[j + 1]) continue;
+
+                // 注意：递归会扩容 nodes，不能持有引用
+                int child = buildNode(rx[i], rz[j], rx[i + 1], rz[j + 1], chunkBounds);
+                nodes[index].children[c++] = child;
+
+                box.min = glm::min(box.min, nodes[child].bounds.min);
+                box.max = glm::max(box.max, nodes[child].bounds.max);
+            }
+        }
+    }
+
+    nodes[index].bounds = box;
+    nodes[index].last = (int)leafOrder.size();
+    return index;
+}
+
+inline void TerrainQuadtree::refit(const std::vector<AABB>& chunkBounds) {
+    // 节点按先序创建，子节点下标总大于父节点：倒序遍历即自底向上
+    for (int n = (int)nodes.size() - 1; n >= 0; --n) {
+        Node& node = nodes[n];
+        if (node.children[0] < 0) {
+            node.bounds = chunkBounds[leafOrder[node.first]];
+            leafBounds.set(node.first, node.bounds);
+            continue;
+        }
+
+        AABB box;
+        box.min = glm::vec3(std::numeric_limits<float>::max());
+        box.max = glm::vec3(-std::numeric_limits<float>::max());
+        for (int child : node.children) {
+            if (child < 0) break;
+            box.min = glm::min(box.min, nodes[child].bounds.min);
+            box.max = glm::max(box.max, nodes[child].bounds.max);
+        }
+        node.bounds = box;
+    }
+}
+
+inline void TerrainQuadtree::collectVisible(const Frustum& frustum, std::vector<int>& out) const {
+    if (nodes.empty()) return;
+    collectNode(0, frustum, 0x3Fu, out); // 根节点测试全部 6 个平面
+}
+
+inline void TerrainQuadtree::collectNode(int nodeIndex, const Frustum& frustum, unsigned planeMask, std::vector<int>& out) const {
+    const Node& node = nodes[nodeIndex];
+
+    Frustum::Containment c = frustum.classify(node.bounds, planeMask);
+    if (c == Frustum::Containment::Outside) return;
+
+    if (c == Frustum::Containment::Inside || node.children[0] < 0) {
+        acceptAll(node, out);
+        return;
+    }
+
+    // 小子树：叶子 AABB 在 SoA 中连续，一次批量测试完
+    if (node.last - node.first <= BATCH_LEAF_COUNT) {
+        batchScratch.clear();
+        frustum.intersectsBatch(leafBounds, node.first, node.last, batchScratch);
+        for (int leaf : batchScratch) out.push_back(leafOrder[leaf]);
+        return;
+    }
+
+    for (int child : node.children) {
+        if (child < 0) break;
+        collectNode(child, frustum, planeMask, out);
+    }
+}
+
+inline void TerrainQuadtree::acceptAll(const Node& node, std::vector<int>& out) const {
+    out.insert(out.end(), leafOrder.begin() + node.first, leafOrder.begin() + node.last);
+}
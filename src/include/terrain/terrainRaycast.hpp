@@ -0,0 +1,294 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include "heightmap.hpp"
+#include "../threadPool.hpp"
+
+// 射线查询的输入 / 输出
+struct TerrainRay {
+    glm::vec3 origin;
+    glm::vec3 dir;          // 不要求归一化
+    float maxDist = 1e30f;
+};
+
+struct TerrainRayHit {
+    bool hit = false;
+    glm::vec3 point = glm::vec3(0.0f);
+    glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);   // 命中三角形的面法线（朝上）
+    float distance = 0.0f;                              // 沿归一化方向的世界距离
+};
+
+// ====================== TerrainRaycaster ======================
+// 高度场射线求交：与渲染网格相同的三角形（每个单元 tr-bl 对角线切成两个三角形）。
+// 遍历借助 Heightmap 的 min/max 金字塔：射线在某节点内的最低点仍高于节点 max 时整块跳过，
+// 否则下降一层；到底层后逐单元 DDA。开阔地形上的长射线只需几步即可跨过。
+// 计算在网格空间进行：x/z 为采样坐标，y 保持世界高度，t 与世界距离一致。
+// 起点已在地表以下时，在起点（或进入地形包围盒处）报告命中。
+// =============================================================
+class TerrainRaycaster {
+public:
+    TerrainRaycaster(const Heightmap& heightmap, float gridScale)
+        : heightmap(heightmap), gridScale(gridScale) {}
+
+    // 单条射线（金字塔加速）
+    TerrainRayHit raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const;
+
+    // 批量射线：在共享线程池上并行，hits 与 rays 一一对应
+    void raycastBatch(const TerrainRay* rays, size_t count, TerrainRayHit* hits) const;
+    void raycastBatch(const std::vector<TerrainRay>& rays, std::vector<TerrainRayHit>& hits) const;
+
+    // 参考实现：不用金字塔，逐单元走完整条射线（用于基准与结果校验）
+    TerrainRayHit raycastLinear(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const;
+
+private:
+    // 网格空间中的射线与有效区间
+    struct GridRay {
+        glm::vec3 o, d;
+        glm::vec3 worldOrigin, worldDir;
+        float tEnter, tExit;
+    };
+
+    bool setup(const glm::vec3& origin, const glm::vec3& dir, float maxDist, GridRay& ray) const;
+    TerrainRayHit traverse(const GridRay& ray, bool hierarchical) const;
+
+    // 逐单元 DDA，检查 [tStart, tEnd]；命中返回 true
+    bool marchCells(const GridRay& ray, float tStart, float tEnd, float& tHit, glm::vec3& normal) const;
+    // 单元 (cx, cz) 的两个三角形
+    bool intersectCell(const GridRay& ray, int cx, int cz, float tMin, float tMax, float& tHit, glm::vec3& normal) const;
+
+    // 坐标 v（沿方向 d 前进）所在单元，限制在 [0, cells - 1]
+    static int cellOf(float v, int cells) {
+        int c = (int)std::floor(v);
+        return c < 0 ? 0 : (c >= cells ? cells - 1 : c);
+    }
+    // 沿一个轴离开 [lo, hi] 的参数
+    static float slabExit(float o, float d, float lo, float hi) {
+        if (d > 0.0f) return (hi - o) / d;
+        if (d < 0.0f) return (lo - o) / d;
+        return std::numeric_limits<float>::infinity();
+    }
+
+    // 边界上为避免停在原地而前进的最小步长（世界单位）
+    static constexpr float STEP_EPS = 1e-3f;
+
+private:
+    const Heightmap& heightmap;
+    float gridScale;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline bool TerrainRaycaster::setup(const glm::vec3& origin, const glm::vec3& dir, float maxDist, GridRay& ray) const {
+    float len = glm::length(dir);
+    if (len <= 0.0f || heightmap.getPyramid().empty()) return false;
+
+    ray.worldOrigin = origin;
+    ray.worldDir = dir / len;
+
+    // 世界 → 网格（与 TerrainChunk 顶点位置一致）
+    const float halfW = (heightmap.width - 1) * 0.5f;
+    const float halfH = (heightmap.height - 1) * 0.5f;
+    ray.o = glm::vec3(origin.x / gridScale + halfW, origin.y, origin.z / gridScale + halfH);
+    ray.d = glm::vec3(ray.worldDir.x / gridScale, ray.worldDir.y, ray.worldDir.z / gridScale);
+
+    // 裁剪到地形包围盒（高度取金字塔根节点）
+    const HeightPyramid& pyramid = heightmap.getPyramid();
+    HeightPyramid::MinMax root = pyramid.node(pyramid.levelCount() - 1, 0, 0);
+    const glm::vec3 lo(0.0f, root.min * heightmap.sampleToHeight(), 0.0f);
+    const glm::vec3 hi((float)(heightmap.width - 1), root.max * heightmap.sampleToHeight(), (float)(heightmap.height - 1));
+
+    float t0 = 0.0f, t1 = maxDist;
+    for (int a = 0; a < 3; ++a) {
+        if (ray.d[a] == 0.0f) {
+            if (ray.o[a] < lo[a] || ray.o[a] > hi[a]) return false;
+            continue;
+        }
+        float inv = 1.0f / ray.d[a];
+        float ta = (lo[a] - ray.o[a]) * inv;
+        float tb = (hi[a] - ray.o[a]) * inv;
+        if (ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if (t0 > t1) return false;
+    }
+
+    ray.tEnter = t0;
+    ray.tExit = t1;
+    return true;
+}
+
+inline TerrainRayHit TerrainRaycaster::raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const {
+    GridRay ray;
+    if (!setup(origin, dir, maxDist, ray)) return TerrainRayHit();
+    return traverse(ray, true);
+}
+
+inline TerrainRayHit TerrainRaycaster::raycastLinear(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const {
+    GridRay ray;
+    if (!setup(origin, dir, maxDist, ray)) return TerrainRayHit();
+    return traverse(ray, false);
+}
+
+inline void TerrainRaycaster::raycastBatch(const TerrainRay* rays, size_t count, TerrainRayHit* hits) const {
+    ThreadPool::shared().parallelFor(0, (int)count, [&](int i) {
+        hits[i] = raycast(rays[i].origin, rays[i].dir, rays[i].maxDist);
+    }, 256);
+}
+
+inline void TerrainRaycaster::raycastBatch(const std::vector<TerrainRay>& rays, std::vector<TerrainRayHit>& hits) const {
+    hits.resize(rays.size());
+    raycastBatch(rays.data(), rays.size(), hits.data());
+}
+
+inline TerrainRayHit TerrainRaycaster::traverse(const GridRay& ray, bool hierarchical) const {
+    TerrainRayHit result;
+    float tHit = 0.0f;
+    glm::vec3 normal;
+    bool found = false;
+
+    if (!hierarchical) {
+        found = marchCells(ray, ray.tEnter, ray.tExit, tHit, normal);
+    }
+    else {
+        const HeightPyramid& pyramid = heightmap.getPyramid();
+        const float toHeight = heightmap.sampleToHeight();
+        const int cellsX = heightmap.width - 1;
+        const int cellsZ = heightmap.height - 1;
+        const int top = pyramid.levelCount() - 1;
+
+        int level = top;
+        float t = ray.tEnter;
+        while (t <= ray.tExit) {
+            // 当前点所在节点（稍微前进一点，避免落在边界上时选错节点）
+            glm::vec3 p = ray.o + ray.d * (t + STEP_EPS * 0.5f);
+            const int cx = cellOf(p.x, cellsX);
+            const int cz = cellOf(p.z, cellsZ);
+            const int span = HeightPyramid::nodeCells(level);
+            const int nx = cx / span;
+            const int nz = cz / span;
+
+            // 射线离开该节点的参数
+            float x0 = (float)(nx * span), x1 = (float)std::min((nx + 1) * span, cellsX);
+            float z0 = (float)(nz * span), z1 = (float)std::min((nz + 1) * span, cellsZ);
+            float tNode = std::min(slabExit(ray.o.x, ray.d.x, x0, x1), slabExit(ray.o.z, ray.d.z, z0, z1));
+            tNode = std::min(std::max(tNode, t), ray.tExit);
+
+            // 射线在节点内的最低点仍高于节点最高点：整块跳过；
+            // 跨进了新的父节点时回到更粗的层（仍在原父节点内说明父节点跳不过，留在本层）
+            float yLow = std::min(ray.o.y + ray.d.y * t, ray.o.y + ray.d.y * tNode);
+            if (yLow > pyramid.node(level, nx, nz).max * toHeight) {
+                t = tNode + STEP_EPS;
+                glm::vec3 q = ray.o + ray.d * (t + STEP_EPS * 0.5f);
+                const int qx = cellOf(q.x, cellsX);
+                const int qz = cellOf(q.z, cellsZ);
+                while (level < top) {
+                    const int shift = HeightPyramid::BASE_SHIFT + level + 1;
+                    if ((qx >> shift) == (cx >> shift) && (qz >> shift) == (cz >> shift)) break;
+                    ++level;
+                }
+                continue;
+            }
+
+            if (level > 0) {
+                --level;
+                continue;
+            }
+
+            // 底层节点：逐单元求交
+            if (marchCells(ray, t, tNode, tHit, normal)) {
+                found = true;
+                break;
+            }
+            t = tNode + STEP_EPS;
+        }
+    }
+
+    if (!found) return result;
+
+    result.hit = true;
+    result.distance = tHit;
+    result.point = ray.worldOrigin + ray.worldDir * tHit;
+    result.normal = normal;
+    return result;
+}
+
+inline bool TerrainRaycaster::marchCells(const GridRay& ray, float tStart, float tEnd, float& tHit, glm::vec3& normal) const {
+    const int cellsX = heightmap.width - 1;
+    const int cellsZ = heightmap.height - 1;
+
+    float t = tStart;
+    while (t <= tEnd) {
+        glm::vec3 p = ray.o + ray.d * (t + STEP_EPS * 0.5f);
+        int cx = cellOf(p.x, cellsX);
+        int cz = cellOf(p.z, cellsZ);
+
+        float tCell = std::min(slabExit(ray.o.x, ray.d.x, (float)cx, (float)(cx + 1)),
+                               slabExit(ray.o.z, ray.d.z, (float)cz, (float)(cz + 1)));
+        tCell = std::min(std::max(tCell, t), tEnd);
+
+        if (intersectCell(ray, cx, cz, t - STEP_EPS, tCell + STEP_EPS, tHit, normal)) return true;
+        t = tCell + STEP_EPS;
+    }
+    return false;
+}
+
+inline bool TerrainRaycaster::intersectCell(const GridRay& ray, int cx, int cz, float tMin, float tMax, float& tHit, glm::vec3& normal) const {
+    const float toHeight = heightmap.sampleToHeight();
+    const unsigned short* r0 = heightmap.row(cz) + cx;
+    const unsigned short* r1 = heightmap.row(cz + 1) + cx;
+
+    // tl = (cx, cz), tr = (cx+1, cz), bl = (cx, cz+1), br = (cx+1, cz+1)
+    const float tl = r0[0] * toHeight, tr = r0[1] * toHeight;
+    const float bl = r1[0] * toHeight, br = r1[1] * toHeight;
+
+    // 快速剔除：区间内射线最低点高于四角最高点
+    float yLow = std::min(ray.o.y + ray.d.y * tMin, ray.o.y + ray.d.y * tMax);
+    if (yLow > std::max(std::max(tl, tr), std::max(bl, br))) return false;
+
+    // 单元内局部坐标 (u, v) ∈ [0, 1] x [0, 1]，相对单元角点计算以保证远处射线的精度。
+    // 对角线 u + v = 1 把单元分成两个平面三角形，射线高度减地表高度 f(t) 在每段上是线性的，
+    // 找第一段由正变为非正的位置即可；相邻单元共享边界上的 f，不会因掠射漏掉穿越点
+    const float ou = ray.o.x - (float)cx, ov = ray.o.z - (float)cz;
+    auto f = [&](float t, bool upper) {
+        float u = ou + ray.d.x * t;
+        float v = ov + ray.d.z * t;
+        float h = upper ? tl + (tr - tl) * u + (bl - tl) * v
+                        : br + (bl - br) * (1.0f - u) + (tr - br) * (1.0f - v);
+        return ray.o.y + ray.d.y * t - h;
+        };
+
+    // 与对角线的交点把 [tMin, tMax] 分成至多两段
+    float segs[3] = { tMin, tMax, tMax };
+    int segCount = 1;
+    const float ds = ray.d.x + ray.d.z;
+    if (ds != 0.0f) {
+        float tDiag = (1.0f - ou - ov) / ds;
+        if (tDiag > tMin && tDiag < tMax) {
+            segs[1] = tDiag;
+            segCount = 2;
+        }
+    }
+
+    for (int k = 0; k < segCount; ++k) {
+        const float ta = segs[k], tb = segs[k + 1];
+        const float tm = 0.5f * (ta + tb);
+        const bool upper = (ou + ray.d.x * tm) + (ov + ray.d.z * tm) <= 1.0f;
+
+        const float fa = f(ta, upper);
+        const float fb = f(tb, upper);
+        if (fa > 0.0f && fb > 0.0f) continue;
+
+        tHit = std::max((fa <= 0.0f) ? ta : ta + (tb - ta) * fa / (fa - fb), 0.0f);
+
+        // 面法线换回世界空间（x/z 除以 gridScale 的斜率），朝上
+        glm::vec3 n = upper
+            ? glm::vec3(-(tr - tl) / gridScale, 1.0f, -(bl - tl) / gridScale)
+            : glm::vec3((bl - br) / gridScale, 1.0f, (tr - br) / gridScale);
+        normal = glm::normalize(n);
+        return true;
+    }
+    return false;
+}
@@ -1,11 +1,69 @@
 #pragma once
 #include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <iostream>
 #include <glm/glm.hpp>
 
 #include "terrainChunk.hpp"
+#include "terrainNormalField.hpp"
+#include "terrainIndexBuffer.hpp"
+#include "terrainBatch.hpp"
+#include "terrainQuadtree.hpp"
+#include "terrainPager.hpp"
+#include "terrainInstancer.hpp"
+#include "terrainRaycast.hpp"
+#include "terrainOcclusion.hpp"
 #include "frustumCulling.hpp"
 #include "heightmap.hpp"
 #include "../shader.hpp"
+#include "../threadPool.hpp"
+
+// 批量高度 / 法线采样的 SIMD 路径：AVX2 一次 8 个点（gather 取采样），否则逐点走标量
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TERRAIN_SAMPLE_AVX2 1
+#endif
+
+// 地形渲染模式
+enum class TerrainRenderMode {
+    PerChunk,   // 每个 chunk 独立 VAO/VBO，逐个 glDrawElements
+    MultiDraw,  // 所有 chunk 共用一个大 VBO，每个 LOD 一次 glMultiDrawElementsBaseVertex
+    Paged,      // 只有相机附近的 chunk 常驻（TerrainPager），绘制方式同 MultiDraw；只能在构造时选择
+    Instanced,  // 顶点纹理拾取：heightmap / 法线作为纹理上传，同一 LOD 的 chunk 一次 glDrawElementsInstanced；不需要 chunk 顶点
+    Clipmap,    // 几何 clipmap（TerrainClipmap，由 Terrain 绘制）：以相机为中心的嵌套环形网格；TerrainSystem 只负责查询
+    Tessellated // 硬件细分（GL 4.0）：每个可见 chunk 几个四边形 patch，细分级别由 TCS 按屏幕边长决定；不需要 chunk 顶点 / 离散 LOD / skirt
+};
+
+// LOD 选择依据
+enum class TerrainLODMetric {
+    Distance,           // 到 chunk 中心的距离与三个固定阈值（setLODDistances）
+    ScreenSpaceError    // 预计算几何误差投影到屏幕的像素数不超过容差（setLODPixelError）
+};
+
+// LOD 接缝处理方式
+enum class TerrainSeamMode {
+    Skirts,     // 每个 chunk 四边下拉 skirt 遮住裂缝
+    Stitched    // 相邻 chunk LOD 最多差一级，细的一侧用缝合索引变体对齐粗边；不画 skirt
+};
+
+// 地形编辑：世界空间 XZ 矩形（闭区间）
+struct TerrainRect {
+    float minX, minZ, maxX, maxZ;
+};
+
+// heightmap 采样矩形 [x0, x1] x [z0, z1]（闭区间）；x0 > x1 表示为空
+struct TerrainSampleRect {
+    int x0 = 0, z0 = 0, x1 = -1, z1 = -1;
+    bool empty() const { return x0 > x1 || z0 > z1; }
+};
+
+// 编辑回调：输入采样点的世界坐标与当前世界高度，返回新高度（裁剪到 [0, heightScale] 并量化为 16 位）
+using TerrainHeightEdit = std::function<float(float worldX, float worldZ, float height)>;
 
 class TerrainSystem {
 public:
@@ -14,30 +72,71 @@ public:
         int chunkCountX,
         int chunkCountZ,
         int chunkSize,
-        float gridScale
+        float gridScale,
+        TerrainRenderMode mode = TerrainRenderMode::MultiDraw,
+        const TerrainPagerSettings& paging = TerrainPagerSettings()
     )
-        : heightmap(heightmap), gridScale(gridScale)
+        : heightmap(heightmap),
+        chunkSize(chunkSize), chunkCountX(chunkCountX), chunkCountZ(chunkCountZ),
+        renderMode(mode),
+        gridScale(gridScale),
+        raycaster(heightmap, gridScale)
     {
+        // heightmap 只多存一圈边缘采样，chunk 网格不能超出 heightmap 范围
+        int maxCountX = std::max(1, (heightmap.width - 1) / (chunkSize - 1));
+        int maxCountZ = std::max(1, (heightmap.height - 1) / (chunkSize - 1));
+        if (chunkCountX > maxCountX || chunkCountZ > maxCountZ) {
+            std::cerr << "TerrainSystem: " << chunkCountX << "x" << chunkCountZ
+                << " chunks exceed the heightmap, clamped to "
+                << std::min(chunkCountX, maxCountX) << "x" << std::min(chunkCountZ, maxCountZ) << std::endl;
+            chunkCountX = this->chunkCountX = std::min(chunkCountX, maxCountX);
+            chunkCountZ = this->chunkCountZ = std::min(chunkCountZ, maxCountZ);
+        }
+
         chunks.reserve(chunkCountX * chunkCountZ);
 
         worldSizeX = chunkCountX * (chunkSize - 1) * gridScale;
         worldSizeZ = chunkCountZ * (chunkSize - 1) * gridScale;
 
+        // 所有 chunk 共用同一套 LOD / skirt 索引，只生成一次
+        indexBuffer.build(chunkSize);
+
+        // 全分辨率法线场：chunk 顶点、实例化法线纹理与法线查询共用
+        normalField.build(heightmap, gridScale);
 
         for (int z = 0; z < chunkCountZ; ++z) {
             for (int x = 0; x < chunkCountX; ++x) {
                 chunks.emplace_back(
                     heightmap,
+                    normalField,
                     x,
                     z,
                     chunkSize,
-                    gridScale
+                    gridScale,
+                    indexBuffer
                 );
             }
         }
+
+        // CPU 构建在线程池中并行，主线程边等边分批上传（分页 / 实例化 / clipmap 模式只算 bounds）
+        if (renderMode == TerrainRenderMode::Paged || renderMode == TerrainRenderMode::Instanced ||
+            renderMode == TerrainRenderMode::Clipmap || renderMode == TerrainRenderMode::Tessellated)
+            buildChunkBounds();
+        else
+            buildChunks();
+
+        // 在 chunk 网格上建立 min/max 四叉树，用于层次视锥裁剪
+        rebuildQuadtree();
+        visibleChunks.reserve(chunks.size());
+
+        // 按当前模式上传 GPU 资源；分页模式由 pager 按需构建 / 上传
+        if (renderMode == TerrainRenderMode::Paged)
+            pager = std::make_unique<TerrainPager>(chunks, chunkCountX, chunkCountZ, chunkSize, gridScale, indexBuffer, paging);
+        else
+            setRenderMode(renderMode);
     }
 
-    // ==================== ƽӿ ====================
+    // ==================== 主绘制接口 ====================
     // viewProj = projection * view
     void Draw(
         Shader& shader,
@@ -47,29 +146,255 @@ public:
         const glm::vec3& cameraPos
     )
     {
-        // 1. ׶
+        // 先在时间预算内重建被编辑的 chunk 顶点（与模式无关：切回顶点模式时数据已是新的）
+        processDirtyChunks();
+
+        // clipmap 模式不经过 chunk 网格
+        if (renderMode == TerrainRenderMode::Clipmap) return;
+
+        // 1. 更新视锥
         glm::mat4 viewProj = projection * view;
         frustum.updateFromMatrix(viewProj);
 
+        // 屏幕空间误差：世界误差 e 在距离 d 处约占 e * projScale / d 像素
+        GLint viewport[4];
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        lodProjScale = projection[1][1] * viewport[3] * 0.5f;
+
+        // 分页模式：先推进后台构建 / 限量上传 / 淘汰
+        const bool paged = (renderMode == TerrainRenderMode::Paged);
+        if (paged) pager->update(cameraPos);
+
+        // 压缩顶点在 terrain.vs 中重建位置所需的网格参数
+        setGridUniforms(shader);
+        const bool instanced = (renderMode == TerrainRenderMode::Instanced);
+        shader.setInt("uInstanced", instanced ? 1 : 0);
+
+        // 2. 四叉树层次裁剪，得到可见 chunk 列表
+        visibleChunks.clear();
+        quadtree.collectVisible(frustum, visibleChunks);
+
+        // 2.5 地平线遮挡：剔除被近处山脊挡住的 chunk（相机须在地面之上且在地形范围内，结论才保守）
+        occlusionStats = TerrainOcclusionStats();
+        occlusionStats.tested = (int)visibleChunks.size();
+        if (occlusionCulling && cameraAboveTerrain(cameraPos)) {
+            horizonCuller.cull(cameraPos, chunkBounds, chunkGround, visibleChunks);
+            occlusionStats = horizonCuller.getStats();
+        }
+
+        // 细分模式：可见 chunk 直接作为 patch 实例提交，LOD 与接缝都由细分着色器处理
+        if (renderMode == TerrainRenderMode::Tessellated) {
+            drawTessellated(shader, cameraPos);
+            return;
+        }
+
+        // 缝合模式：LOD 需要与邻居一致（含不可见的邻居），先对整个网格求一遍
+        const bool stitched = (seamMode == TerrainSeamMode::Stitched);
+        if (stitched) computeStitchedLODs(cameraPos);
+
+        // 3. 只对可见 chunk 选 LOD（批量模式只填绘制列表，不直接发 draw call）
+        const bool batched = (renderMode == TerrainRenderMode::MultiDraw || paged);
+        TerrainBatch& drawBatch = paged ? pager->getBatch() : batch;
+        if (batched) drawBatch.begin();
+        if (instanced) instancer.begin();
+
+        for (int i : visibleChunks) {
+            TerrainChunk& chunk = chunks[i];
+
+            // ---- LOD 选择 ----
+            int lod;
+            int mask = 0;
+            TerrainIndexRange range;
+            if (stitched) {
+                lod = chunkLOD[i];
+                mask = stitchMask(i);
+                range = indexBuffer.stitched(lod, mask);
+            }
+            else {
+                lod = pickLOD(chunk, cameraPos);
+                range = indexBuffer.combined(lod);
+            }
+
+            // ---- 绘制 ----
+            if (instanced) {
+                instancer.add(i, lod, mask, range);
+            }
+            else if (paged) {
+                // 尚未驻留的 chunk 本帧跳过
+                int slot = pager->slotOf(i);
+                if (slot >= 0) drawBatch.add(slot, lod, range);
+            }
+            else if (batched) {
+                drawBatch.add(i, lod, range);
+            }
+            else {
+                shader.setInt("uChunkIndex", i);
+                chunk.Draw(shader, range);
+            }
+        }
+
+        // 4. 批量提交（chunk 下标由 baseVertex 隐含在 gl_VertexID 中；分页模式隐含的是槽位）
+        if (batched) {
+            shader.setInt("uChunkIndex", 0);
+            shader.setInt("uPaged", paged ? 1 : 0);
+            if (paged) pager->bindSlotTexture(TERRAIN_SLOT_TEXTURE_UNIT);
+            drawBatch.flush();
+        }
+        else if (instanced) {
+            shader.setInt("uPaged", 0);
+            instancer.bindTextures();
+            instancer.flush();
+        }
+    }
+
+    // ==================== 渲染模式 ====================
+    // 切换渲染模式；对应的 GPU 资源在第一次切换时才创建
+    void setRenderMode(TerrainRenderMode mode)
+    {
+        // 分页模式下 chunk 不全驻留，与其它模式互切需要重建整个地形
+        if (mode != renderMode &&
+            (mode == TerrainRenderMode::Paged || renderMode == TerrainRenderMode::Paged)) {
+            std::cerr << "TerrainSystem: paged mode can only be selected at construction" << std::endl;
+            return;
+        }
+
+        renderMode = mode;
+
+        // clipmap 的 GPU 资源由 Terrain 持有
+        if (mode == TerrainRenderMode::Clipmap) return;
+
+        // 细分需要 GL 4.0；上下文不支持时退回实例化模式（两者共用高度 / 法线纹理）
+        if (mode == TerrainRenderMode::Tessellated && !tessellationSupported()) {
+            std::cerr << "TerrainSystem: tessellation requires OpenGL 4.0, falling back to instanced mode" << std::endl;
+            mode = renderMode = TerrainRenderMode::Instanced;
+        }
+
+        if (mode == TerrainRenderMode::Instanced || mode == TerrainRenderMode::Tessellated) {
+            instancer.build(heightmap, normalField, chunkCountX, (int)chunks.size(), indexBuffer);
+            return;
+        }
+
+        // 以实例化 / clipmap / 细分模式构造时没有生成 chunk 顶点：第一次切到其它模式时补建（buildChunks 按当前模式上传）
+        if (!chunksBuilt) {
+            buildChunks();
+            return;
+        }
+
+        if (mode == TerrainRenderMode::MultiDraw) {
+            batch.build(chunks, indexBuffer);
+        }
+        else {
+            for (auto& chunk : chunks) chunk.setupMesh();
+        }
+    }
+
+    TerrainRenderMode getRenderMode() const { return renderMode; }
+
+    // 细分模式：细分后每段边的目标像素长度（越小越细）
+    void setTessellationPixels(float pixels) { tessPixels = std::max(pixels, 0.5f); }
+
+    // 分页模式的调度器（其它模式为 nullptr）
+    const TerrainPager* getPager() const { return pager.get(); }
 
-        // 2.  Chunk
-        for (auto& chunk : chunks) {
+    // ==================== 接缝模式 ====================
+    // 切换 skirt / 缝合；bounds 随之收紧或放宽，并重建四叉树
+    void setSeamMode(TerrainSeamMode mode)
+    {
+        if (mode == seamMode) return;
+        seamMode = mode;
+
+        // 分页的后台构建只生成顶点，不碰 bounds，这里无需等待
+        const float depth = (mode == TerrainSeamMode::Stitched) ? 0.0f : TERRAIN_SKIRT_DEPTH;
+        ThreadPool::shared().parallelFor(0, (int)chunks.size(), [this, depth](int i) {
+            chunks[i].setSkirtDepth(depth);
+            chunks[i].computeBounds();
+        }, chunkCountX);
+
+        rebuildQuadtree();
+    }
+
+    TerrainSeamMode getSeamMode() const { return seamMode; }
+
+    // ==================== 地形编辑 ====================
+    // 改写世界矩形内的 heightmap 采样（车辙、压平花坛等），必须在 GL 线程调用。立即生效的部分：
+    //   - heightmap、边缘填充、min/max 金字塔（高度 / 法线 / 射线查询马上看到新地形）
+    //   - 受影响 chunk（采样外扩一圈，法线会变）的 bounds、遮挡足迹与四叉树（refit，不重建）
+    //   - 实例化 / 细分模式的高度与法线纹理（glTexSubImage2D 局部重传）
+    // 有顶点数据的 chunk 只登记为脏，由之后的 Draw 在 setEditBudget 的时间预算内重建并 glBufferSubData；
+    // 分页模式下未驻留的 chunk 以后按新高度构建。返回实际改写的采样矩形（clipmap 由 Terrain 据此刷新）
+    TerrainSampleRect modifyHeights(const TerrainRect& rect, const TerrainHeightEdit& fn)
+    {
+        // 只改中心落在矩形内的采样
+        const float halfW = (heightmap.width - 1) * 0.5f;
+        const float halfH = (heightmap.height - 1) * 0.5f;
+        TerrainSampleRect r;
+        r.x0 = (int)std::ceil(rect.minX / gridScale + halfW);
+        r.z0 = (int)std::ceil(rect.minZ / gridScale + halfH);
+        r.x1 = (int)std::floor(rect.maxX / gridScale + halfW);
+        r.z1 = (int)std::floor(rect.maxZ / gridScale + halfH);
+        if (r.empty()) return TerrainSampleRect();
 
-            // ---- ׶ü ----
-            if (!frustum.intersects(chunk.getAABBWorld()))
-                continue;
+        // 后台构建会读 heightmap，先等它们结束
+        if (pager) pager->waitIdle();
 
+        const float toHeight = heightmap.sampleToHeight();
+        const float toRaw = 65535.0f / heightmap.heightScale;
+        bool changed = heightmap.modify(r.x0, r.z0, r.x1, r.z1, [&](int x, int z, unsigned short raw) {
+            float h = fn((x - halfW) * gridScale, (z - halfH) * gridScale, raw * toHeight);
+            return (unsigned short)std::lround(glm::clamp(h * toRaw, 0.0f, 65535.0f));
+        });
+        if (!changed) return TerrainSampleRect();
 
-            // ---- LOD ѡ ----
-            float distance = glm::distance(cameraPos, chunk.getCenter());
-            int lod = pickLOD(distance);
+        normalField.update(r.x0, r.z0, r.x1, r.z1);
+        if (instancer.isBuilt()) instancer.updateRegion(heightmap, normalField, r.x0, r.z0, r.x1, r.z1);
 
-            // ----  ----
-            chunk.Draw(shader, lod);
+        // 受影响的 chunk：顶点范围与 [x0 - 1, x1 + 1] x [z0 - 1, z1 + 1] 相交（中央差分法线）
+        const int cells = chunkSize - 1;
+        int cx0 = std::max(0, (std::max(r.x0 - 1, 0) + cells - 1) / cells - 1);
+        int cz0 = std::max(0, (std::max(r.z0 - 1, 0) + cells - 1) / cells - 1);
+        int cx1 = std::min(chunkCountX - 1, (r.x1 + 1) / cells);
+        int cz1 = std::min(chunkCountZ - 1, (r.z1 + 1) / cells);
+
+        editedChunks.clear();
+        for (int z = cz0; z <= cz1; ++z) {
+            for (int x = cx0; x <= cx1; ++x) editedChunks.push_back(z * chunkCountX + x);
+        }
+
+        // bounds / LOD 误差直接读 heightmap，马上重算；四叉树只 refit
+        ThreadPool::shared().parallelFor(0, (int)editedChunks.size(), [this](int k) {
+            chunks[editedChunks[k]].computeBounds();
+        });
+        for (int i : editedChunks) {
+            chunkBounds[i] = chunks[i].getAABBWorld();
+            updateChunkGround(i);
         }
+        quadtree.refit(chunkBounds);
+
+        // 顶点：只有已生成（分页模式为已驻留）的 chunk 需要重建
+        for (int i : editedChunks) {
+            bool hasVertices = pager ? pager->invalidate(i) : chunksBuilt;
+            if (!hasVertices || chunkDirty[i]) continue;
+            chunkDirty[i] = 1;
+            dirtyChunks.push_back(i);
+        }
+        return r;
     }
 
-    // ==================== LOD ӿ ====================
+    // 每帧重建被编辑 chunk 顶点的时间预算（毫秒）；每帧至少处理一批，保证前进
+    void setEditBudget(float ms) { editBudgetMs = std::max(ms, 0.0f); }
+    // 等待重建的 chunk 数
+    int getPendingEditChunks() const { return (int)dirtyChunks.size(); }
+
+    // ==================== 遮挡裁剪 ====================
+    // 开关 CPU 地平线遮挡（默认开启）
+    void setOcclusionCulling(bool enabled) { occlusionCulling = enabled; }
+    bool getOcclusionCulling() const { return occlusionCulling; }
+
+    // 上一帧视锥裁剪后参与测试 / 被地平线遮挡剔除的 chunk 数
+    const TerrainOcclusionStats& getOcclusionStats() const { return occlusionStats; }
+
+    // ==================== LOD 参数接口 ====================
+    // 按距离阈值选 LOD（切换到 Distance 度量）
     void setLODDistances(
         float lod0,
         float lod1,
@@ -79,17 +404,27 @@ public:
         lod0Distance = lod0;
         lod1Distance = lod1;
         lod2Distance = lod2;
+        lodMetric = TerrainLODMetric::Distance;
+    }
+
+    // 按屏幕空间误差选 LOD：允许的最大像素误差（切换到 ScreenSpaceError 度量）
+    void setLODPixelError(float pixels)
+    {
+        lodPixelError = std::max(pixels, 0.01f);
+        lodMetric = TerrainLODMetric::ScreenSpaceError;
     }
 
+    TerrainLODMetric getLODMetric() const { return lodMetric; }
+
     float getWorldSizeX() const { return worldSizeX; }
     float getWorldSizeZ() const { return worldSizeZ; }
 
 
-    // ===================== ߶Ȳѯ ========================
-    // (x, z)߶y
+    // ===================== 世界高度查询 ========================
+    // 输入世界坐标(x, z)，输出世界高度y
     // ===========================================================
     float getHeightWorld(float worldX, float worldZ) const {
-        //   heightmap 
+        // 世界坐标 → heightmap 网格坐标
         float halfW = (heightmap.width - 1) * 0.5f;
         float halfH = (heightmap.height - 1) * 0.5f;
 
@@ -100,38 +435,35 @@ public:
         float gridZ = (worldZ + halfH) / gridScale;
 
 
-        // Խ
+        // 越界检查
         if (gridX < 0.0f || gridZ < 0.0f ||
             gridX > heightmap.width - 1 ||
             gridZ > heightmap.height - 1)
         {
-            return 0.0f; // ҪĬϸ߶
+            return 0.0f; // 或你需要的默认高度
         }
 
         int x0 = static_cast<int>(std::floor(gridX));
         int z0 = static_cast<int>(std::floor(gridZ));
-        int x1 = std::min(x0 + 1, heightmap.width - 1);
-        int z1 = std::min(z0 + 1, heightmap.height - 1);
 
         float sx = gridX - x0;
         float sz = gridZ - z0;
 
-        float h00 = heightmap.get(x0, z0);
-        float h10 = heightmap.get(x1, z0);
-        float h01 = heightmap.get(x0, z1);
-        float h11 = heightmap.get(x1, z1);
+        // 右 / 下邻居可能落在边缘填充上，无需 clamp；先插值原始采样，最后统一反量化
+        const unsigned short* r0 = heightmap.row(z0);
+        const unsigned short* r1 = heightmap.row(z0 + 1);
 
-        float h0 = glm::mix(h00, h10, sx);
-        float h1 = glm::mix(h01, h11, sx);
-        return glm::mix(h0, h1, sz);
+        float h0 = glm::mix((float)r0[x0], (float)r0[x0 + 1], sx);
+        float h1 = glm::mix((float)r1[x0], (float)r1[x0 + 1], sx);
+        return glm::mix(h0, h1, sz) * heightmap.sampleToHeight();
     }
 
-    // ===================== 編߲ѯ ========================
-    // (x, z)õķ
+    // ===================== 世界法线查询 ========================
+    // 输入世界坐标(x, z)，输出该点的法线
     // ===========================================================
     glm::vec3 getNormalWorld(float worldX, float worldZ) const
     {
-        //   heightmap 
+        // 世界 → heightmap 网格坐标
         float halfW = (heightmap.width - 1) * 0.5f;
         float halfH = (heightmap.height - 1) * 0.5f;
 
@@ -151,29 +483,149 @@ public:
         int x = static_cast<int>(std::floor(gridX));
         int z = static_cast<int>(std::floor(gridZ));
 
-        // 
-        float hl = heightmap.get(x - 1, z);
-        float hr = heightmap.get(x + 1, z);
-        float hd = heightmap.get(x, z - 1);
-        float hu = heightmap.get(x, z + 1);
+        // 直接解码预计算的法线场（与渲染顶点的法线一致）
+        return normalField.decode(x, z);
+    }
+
+    // ===================== 批量高度查询 ========================
+    // worldX / worldZ 各 count 个点，结果写入 outY（与 getHeightWorld 逐点结果一致，越界为 0）
+    // ===========================================================
+    void getHeightWorldBatch(const float* worldX, const float* worldZ, float* outY, size_t count) const
+    {
+        size_t i = 0;
+#if defined(TERRAIN_SAMPLE_AVX2)
+        const float halfW = (heightmap.width - 1) * 0.5f;
+        const float halfH = (heightmap.height - 1) * 0.5f;
+        const __m256 vHalfW = _mm256_set1_ps(halfW);
+        const __m256 vHalfH = _mm256_set1_ps(halfH);
+        const __m256 vGrid = _mm256_set1_ps(gridScale);
+        const __m256 vMaxX = _mm256_set1_ps((float)(heightmap.width - 1));
+        const __m256 vMaxZ = _mm256_set1_ps((float)(heightmap.height - 1));
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 toHeight = _mm256_set1_ps(heightmap.sampleToHeight());
+        const __m256i vStride = _mm256_set1_epi32(heightmap.rowStride());
+        const __m256i lowMask = _mm256_set1_epi32(0xFFFF);
+        const int* base = (const int*)heightmap.row(0);
 
-        glm::vec3 n(
-            hl - hr,
-            2.0f * gridScale,
-            hd - hu
-        );
+        for (; i + 8 <= count; i += 8) {
+            __m256 gx = _mm256_div_ps(_mm256_add_ps(_mm256_loadu_ps(worldX + i), vHalfW), vGrid);
+            __m256 gz = _mm256_div_ps(_mm256_add_ps(_mm256_loadu_ps(worldZ + i), vHalfH), vGrid);
+
+            // 越界（含 NaN）的车道坐标置 0，照常取样后结果再清零
+            __m256 valid = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(gx, zero, _CMP_GE_OQ), _mm256_cmp_ps(gz, zero, _CMP_GE_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(gx, vMaxX, _CMP_LE_OQ), _mm256_cmp_ps(gz, vMaxZ, _CMP_LE_OQ)));
+            gx = _mm256_and_ps(gx, valid);
+            gz = _mm256_and_ps(gz, valid);
+
+            __m256 fx = _mm256_floor_ps(gx);
+            __m256 fz = _mm256_floor_ps(gz);
+            __m256 sx = _mm256_sub_ps(gx, fx);
+            __m256 sz = _mm256_sub_ps(gz, fz);
+
+            // 一次 32 位 gather 同时取到 r[x0]（低 16 位）与 r[x0 + 1]（高 16 位）
+            __m256i idx0 = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_cvttps_epi32(fz), vStride), _mm256_cvttps_epi32(fx));
+            __m256i idx1 = _mm256_add_epi32(idx0, vStride);
+            __m256i p0 = _mm256_i32gather_epi32(base, idx0, 2);
+            __m256i p1 = _mm256_i32gather_epi32(base, idx1, 2);
 
-        return glm::normalize(n);
+            __m256 h00 = _mm256_cvtepi32_ps(_mm256_and_si256(p0, lowMask));
+            __m256 h10 = _mm256_cvtepi32_ps(_mm256_srli_epi32(p0, 16));
+            __m256 h01 = _mm256_cvtepi32_ps(_mm256_and_si256(p1, lowMask));
+            __m256 h11 = _mm256_cvtepi32_ps(_mm256_srli_epi32(p1, 16));
+
+            // 与 glm::mix 相同的 a * (1 - t) + b * t
+            __m256 isx = _mm256_sub_ps(one, sx);
+            __m256 h0 = _mm256_add_ps(_mm256_mul_ps(h00, isx), _mm256_mul_ps(h10, sx));
+            __m256 h1 = _mm256_add_ps(_mm256_mul_ps(h01, isx), _mm256_mul_ps(h11, sx));
+            __m256 h = _mm256_add_ps(_mm256_mul_ps(h0, _mm256_sub_ps(one, sz)), _mm256_mul_ps(h1, sz));
+
+            _mm256_storeu_ps(outY + i, _mm256_and_ps(_mm256_mul_ps(h, toHeight), valid));
+        }
+#endif
+        for (; i < count; ++i) {
+            outY[i] = getHeightWorld(worldX[i], worldZ[i]);
+        }
     }
 
-    // ===================== ¶Ȳѯ ========================
-    // (x, z)õ¶ȣȣ
+    // ===================== 批量法线查询 ========================
+    // worldX / worldZ 各 count 个点，结果写入 outN：每点从共享法线场 gather 一个 32 位字再解码
+    // （与 getNormalWorld 逐点结果一致，越界为 (0, 1, 0)）
+    // ===========================================================
+    void getNormalWorldBatch(const float* worldX, const float* worldZ, glm::vec3* outN, size_t count) const
+    {
+        size_t i = 0;
+#if defined(TERRAIN_SAMPLE_AVX2)
+        const float halfW = (heightmap.width - 1) * 0.5f;
+        const float halfH = (heightmap.height - 1) * 0.5f;
+        const __m256 vHalfW = _mm256_set1_ps(halfW);
+        const __m256 vHalfH = _mm256_set1_ps(halfH);
+        const __m256 vGrid = _mm256_set1_ps(gridScale);
+        const __m256 vMaxX = _mm256_set1_ps((float)(heightmap.width - 1));
+        const __m256 vMaxZ = _mm256_set1_ps((float)(heightmap.height - 1));
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256 minusOne = _mm256_set1_ps(-1.0f);
+        const __m256 snormScale = _mm256_set1_ps(32767.0f);
+        const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000u));
+        const __m256i vWidth = _mm256_set1_epi32(normalField.getWidth());
+        const int* base = (const int*)normalField.data();
+
+        alignas(32) float nx[8], nyOut[8], nz[8];
+        for (; i + 8 <= count; i += 8) {
+            __m256 gx = _mm256_div_ps(_mm256_add_ps(_mm256_loadu_ps(worldX + i), vHalfW), vGrid);
+            __m256 gz = _mm256_div_ps(_mm256_add_ps(_mm256_loadu_ps(worldZ + i), vHalfH), vGrid);
+
+            __m256 valid = _mm256_and_ps(
+                _mm256_and_ps(_mm256_cmp_ps(gx, zero, _CMP_GE_OQ), _mm256_cmp_ps(gz, zero, _CMP_GE_OQ)),
+                _mm256_and_ps(_mm256_cmp_ps(gx, vMaxX, _CMP_LE_OQ), _mm256_cmp_ps(gz, vMaxZ, _CMP_LE_OQ)));
+            gx = _mm256_and_ps(gx, valid);
+            gz = _mm256_and_ps(gz, valid);
+
+            // 法线场每个采样是一个 32 位字（低 16 位 px，高 16 位 pz），一次 gather 取齐；越界车道置 0 → (0, 1, 0)
+            __m256i idx = _mm256_add_epi32(
+                _mm256_mullo_epi32(_mm256_cvttps_epi32(_mm256_floor_ps(gz)), vWidth),
+                _mm256_cvttps_epi32(_mm256_floor_ps(gx)));
+            __m256i word = _mm256_and_si256(_mm256_i32gather_epi32(base, idx, 4), _mm256_castps_si256(valid));
+
+            // 与 octDecodeNormal 相同的解码
+            __m256 px = _mm256_max_ps(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(word, 16), 16)), snormScale), minusOne);
+            __m256 pz = _mm256_max_ps(_mm256_div_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(word, 16)), snormScale), minusOne);
+            __m256 ax = _mm256_and_ps(px, absMask);
+            __m256 az = _mm256_and_ps(pz, absMask);
+            __m256 y = _mm256_sub_ps(_mm256_sub_ps(one, ax), az);
+
+            // y < 0 的下半球向外折叠
+            __m256 fold = _mm256_cmp_ps(y, zero, _CMP_LT_OQ);
+            __m256 sx = _mm256_or_ps(one, _mm256_and_ps(px, signMask));
+            __m256 sz = _mm256_or_ps(one, _mm256_and_ps(pz, signMask));
+            __m256 x = _mm256_blendv_ps(px, _mm256_mul_ps(_mm256_sub_ps(one, az), sx), fold);
+            __m256 z = _mm256_blendv_ps(pz, _mm256_mul_ps(_mm256_sub_ps(one, ax), sz), fold);
+
+            __m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z)));
+            __m256 invLen = _mm256_div_ps(one, len);
+
+            _mm256_store_ps(nx, _mm256_mul_ps(x, invLen));
+            _mm256_store_ps(nyOut, _mm256_mul_ps(y, invLen));
+            _mm256_store_ps(nz, _mm256_mul_ps(z, invLen));
+            for (int k = 0; k < 8; ++k) outN[i + k] = glm::vec3(nx[k], nyOut[k], nz[k]);
+        }
+#endif
+        for (; i < count; ++i) {
+            outN[i] = getNormalWorld(worldX[i], worldZ[i]);
+        }
+    }
+
+    // ===================== 世界坡度查询 ========================
+    // 输入世界坐标(x, z)，输出该点的坡度（弧度）
     // ===========================================================
     float getSlopeRadians(float worldX, float worldZ) const
     {
         glm::vec3 n = getNormalWorld(worldX, worldZ);
 
-        // 롰Ϸ򡱵ļн
+        // 与“世界上方向”的夹角
         float cosTheta = glm::clamp(
             glm::dot(n, glm::vec3(0, 1, 0)),
             -1.0f,
@@ -183,19 +635,337 @@ public:
         return std::acos(cosTheta);
     }
 
-    // ===================== ¶Ȳѯ ========================
-    // (x, z)õ¶ȣǶȣ
+    // ===================== 世界坡度查询 ========================
+    // 输入世界坐标(x, z)，输出该点的坡度（角度）
     // ===========================================================
     float getSlopeDegrees(float worldX, float worldZ) const
     {
         return glm::degrees(getSlopeRadians(worldX, worldZ));
     }
 
+    // ===================== 区域高度范围 ========================
+    // 输入世界矩形 [minX, maxX] x [minZ, maxZ]，输出其中地形高度的保守范围
+    // （min/max 金字塔，O(1)；用于相机碰撞、植被、遮挡等粗判）
+    // ===========================================================
+    glm::vec2 getHeightRangeWorld(float minX, float minZ, float maxX, float maxZ) const
+    {
+        // 世界 → 采样坐标，向外取整保证保守
+        float halfW = (heightmap.width - 1) * 0.5f;
+        float halfH = (heightmap.height - 1) * 0.5f;
+        int x0 = (int)std::floor(minX / gridScale + halfW);
+        int z0 = (int)std::floor(minZ / gridScale + halfH);
+        int x1 = (int)std::ceil(maxX / gridScale + halfW);
+        int z1 = (int)std::ceil(maxZ / gridScale + halfH);
+
+        HeightPyramid::MinMax range = heightmap.getRangeRaw(x0, z0, x1, z1);
+        if (range.min > range.max) return glm::vec2(0.0f); // 完全在地图外
+
+        return glm::vec2(range.min, range.max) * heightmap.sampleToHeight();
+    }
+
+    float getMaxHeightWorld(float minX, float minZ, float maxX, float maxZ) const
+    {
+        return getHeightRangeWorld(minX, minZ, maxX, maxZ).y;
+    }
+
+    // ===================== 射线查询 ========================
+    // 与渲染网格求交，返回命中点 / 面法线 / 距离（金字塔加速）
+    // =======================================================
+    TerrainRayHit raycast(const glm::vec3& origin, const glm::vec3& dir, float maxDist) const
+    {
+        return raycaster.raycast(origin, dir, maxDist);
+    }
+
+    // 批量射线，线程池并行
+    void raycastBatch(const std::vector<TerrainRay>& rays, std::vector<TerrainRayHit>& hits) const
+    {
+        raycaster.raycastBatch(rays, hits);
+    }
+
 
 
 
 private:
-    // ==================== LOD ѡ߼ ====================
+    // 并行构建全部 chunk：工作线程做 CPU 构建，主线程在 chunk 完成后分批上传 GPU，并打印耗时报告
+    void buildChunks()
+    {
+        using Clock = std::chrono::high_resolution_clock;
+        auto t0 = Clock::now();
+
+        const int total = (int)chunks.size();
+        ThreadPool& pool = ThreadPool::shared();
+
+        // GL 只能在主线程调用：批量模式先分配整块 VBO
+        if (renderMode == TerrainRenderMode::MultiDraw) {
+            batch.allocate(total, TerrainIndexBuffer::vertexCount(chunkSize), indexBuffer);
+        }
+
+        std::mutex doneMutex;
+        std::condition_variable doneCv;
+        std::vector<int> done;
+        std::atomic<long long> cpuNanos{ 0 };
+
+        // 每个任务负责一行 chunk，完成后整行交给主线程
+        for (int z = 0; z < chunkCountZ; ++z) {
+            pool.submit([&, z] {
+                auto start = Clock::now();
+                std::vector<int> row;
+                row.reserve(chunkCountX);
+                for (int x = 0; x < chunkCountX; ++x) {
+                    int i = z * chunkCountX + x;
+                    chunks[i].build();
+                    row.push_back(i);
+                }
+                cpuNanos += std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    done.insert(done.end(), row.begin(), row.end());
+                }
+                doneCv.notify_one();
+            });
+        }
+
+        // 主线程：取走已完成的 chunk，一批一批上传
+        double uploadMs = 0.0;
+        std::vector<int> ready;
+        int uploaded = 0;
+        while (uploaded < total) {
+            {
+                std::unique_lock<std::mutex> lock(doneMutex);
+                doneCv.wait(lock, [&] { return !done.empty(); });
+                ready.swap(done);
+            }
+
+            auto u0 = Clock::now();
+            for (int i : ready) {
+                if (renderMode == TerrainRenderMode::MultiDraw)
+                    batch.upload(i, chunks[i]);
+                else
+                    chunks[i].setupMesh();
+            }
+            uploadMs += std::chrono::duration<double, std::milli>(Clock::now() - u0).count();
+
+            uploaded += (int)ready.size();
+            ready.clear();
+        }
+
+        double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        double cpuMs = cpuNanos.load() / 1e6;
+
+        chunksBuilt = true;
+
+        std::cout << "[Terrain] Built " << total << " chunks with " << pool.size() << " worker threads: "
+            << totalMs << " ms wall, " << cpuMs << " ms CPU build (x"
+            << (totalMs > 0.0 ? cpuMs / totalMs : 0.0) << " parallel), "
+            << uploadMs << " ms GPU upload on main thread" << std::endl;
+    }
+
+    // 分页 / 实例化模式：只并行计算全部 chunk 的 bounds（直接读 heightmap），不生成顶点
+    void buildChunkBounds()
+    {
+        using Clock = std::chrono::high_resolution_clock;
+        auto t0 = Clock::now();
+
+        ThreadPool::shared().parallelFor(0, (int)chunks.size(), [this](int i) {
+            chunks[i].computeBounds();
+        }, chunkCountX);
+
+        double totalMs = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::cout << "[Terrain] Computed bounds for " << chunks.size() << " chunks (no vertex data): "
+            << totalMs << " ms" << std::endl;
+    }
+
+    // 由全部 chunk 的 AABB 重建四叉树，并记录地平线遮挡用的 bounds / 地表足迹
+    void rebuildQuadtree()
+    {
+        chunkBounds.clear();
+        chunkBounds.reserve(chunks.size());
+        for (const auto& chunk : chunks) chunkBounds.push_back(chunk.getAABBWorld());
+        quadtree.build(chunkCountX, chunkCountZ, chunkBounds);
+
+        chunkGround.resize(chunks.size());
+        for (int i = 0; i < (int)chunks.size(); ++i) updateChunkGround(i);
+
+        chunkDirty.resize(chunks.size(), 0);
+    }
+
+    // 遮挡体：chunk 的精确足迹（不含防闪烁外扩）与地表最低高度（不含 skirt）
+    void updateChunkGround(int i)
+    {
+        const float halfW = (heightmap.width - 1) * gridScale * 0.5f;
+        const float halfH = (heightmap.height - 1) * gridScale * 0.5f;
+        const int cells = chunkSize - 1;
+        const int x = i % chunkCountX;
+        const int z = i / chunkCountX;
+
+        AABB& g = chunkGround[i];
+        g.min = glm::vec3(x * cells * gridScale - halfW,
+            heightmap.getMinHeight(x * cells, z * cells, (x + 1) * cells, (z + 1) * cells),
+            z * cells * gridScale - halfH);
+        g.max = glm::vec3((x + 1) * cells * gridScale - halfW, g.min.y, (z + 1) * cells * gridScale - halfH);
+    }
+
+    // 重建被编辑的 chunk 顶点并原地上传：每批与线程数相当的 chunk 并行 build，超出时间预算后留到下一帧
+    void processDirtyChunks()
+    {
+        if (dirtyChunks.empty()) return;
+
+        using Clock = std::chrono::high_resolution_clock;
+        auto t0 = Clock::now();
+        ThreadPool& pool = ThreadPool::shared();
+        const size_t group = pool.size() + 1;
+
+        size_t next = 0;
+        while (next < dirtyChunks.size()) {
+            size_t end = std::min(dirtyChunks.size(), next + group);
+
+            // 分页模式下登记后被淘汰的 chunk 不再需要（可能已交给 pager 重新构建，不能再碰）
+            rebuildScratch.clear();
+            for (size_t k = next; k < end; ++k) {
+                int i = dirtyChunks[k];
+                chunkDirty[i] = 0;
+                if (!pager || pager->slotOf(i) >= 0) rebuildScratch.push_back(i);
+            }
+
+            // bounds / LOD 误差已在 modifyHeights 中按新高度重算，这里只重建顶点
+            pool.parallelFor(0, (int)rebuildScratch.size(), [this](int k) {
+                chunks[rebuildScratch[k]].buildGeometry();
+            });
+
+            for (int i : rebuildScratch) {
+                if (pager) {
+                    pager->reupload(i);
+                    continue;
+                }
+                if (batch.isBuilt()) batch.upload(i, chunks[i]);
+                if (chunks[i].hasMesh()) chunks[i].updateMesh();
+            }
+
+            next = end;
+            if (std::chrono::duration<double, std::milli>(Clock::now() - t0).count() >= editBudgetMs) break;
+        }
+        dirtyChunks.erase(dirtyChunks.begin(), dirtyChunks.begin() + next);
+    }
+
+    // 相机在地形范围内且高于脚下的渲染地表（地平线遮挡的前提）
+    // 最粗 LOD 的三角形顶点离相机不超过 2^(LOD_COUNT-1) 格，取该窗口内的最高采样即可覆盖任意 LOD
+    bool cameraAboveTerrain(const glm::vec3& cameraPos) const
+    {
+        const float halfW = (heightmap.width - 1) * gridScale * 0.5f;
+        const float halfH = (heightmap.height - 1) * gridScale * 0.5f;
+        if (std::fabs(cameraPos.x) >= halfW || std::fabs(cameraPos.z) >= halfH) return false;
+
+        const int reach = 1 << (TerrainIndexBuffer::LOD_COUNT - 1);
+        int gx = (int)((cameraPos.x + halfW) / gridScale);
+        int gz = (int)((cameraPos.z + halfH) / gridScale);
+        return cameraPos.y > heightmap.getMaxHeight(gx - reach, gz - reach, gx + reach + 1, gz + reach + 1);
+    }
+
+    // 缝合模式的 LOD：先按距离选，再把过粗的 chunk 细化到“不比任何邻居粗一级以上”
+    // （lod[i] = min_j(raw[j] + 网格距离(i, j))，两遍扫描即可求出）
+    void computeStitchedLODs(const glm::vec3& cameraPos)
+    {
+        const int count = (int)chunks.size();
+        chunkLOD.resize(count);
+        for (int i = 0; i < count; ++i) {
+            chunkLOD[i] = pickLOD(chunks[i], cameraPos);
+        }
+
+        // 正向：左、上邻居
+        for (int z = 0; z < chunkCountZ; ++z) {
+            for (int x = 0; x < chunkCountX; ++x) {
+                int i = z * chunkCountX + x;
+                if (x > 0) chunkLOD[i] = std::min(chunkLOD[i], chunkLOD[i - 1] + 1);
+                if (z > 0) chunkLOD[i] = std::min(chunkLOD[i], chunkLOD[i - chunkCountX] + 1);
+            }
+        }
+        // 反向：右、下邻居
+        for (int z = chunkCountZ - 1; z >= 0; --z) {
+            for (int x = chunkCountX - 1; x >= 0; --x) {
+                int i = z * chunkCountX + x;
+                if (x < chunkCountX - 1) chunkLOD[i] = std::min(chunkLOD[i], chunkLOD[i + 1] + 1);
+                if (z < chunkCountZ - 1) chunkLOD[i] = std::min(chunkLOD[i], chunkLOD[i + chunkCountX] + 1);
+            }
+        }
+    }
+
+    // 邻居比自己粗的边组成的缝合掩码（地图边界视为同级）
+    int stitchMask(int i) const
+    {
+        const int x = i % chunkCountX;
+        const int z = i / chunkCountX;
+        const int lod = chunkLOD[i];
+
+        int mask = 0;
+        if (z > 0 && chunkLOD[i - chunkCountX] > lod) mask |= STITCH_TOP;
+        if (x < chunkCountX - 1 && chunkLOD[i + 1] > lod) mask |= STITCH_RIGHT;
+        if (z < chunkCountZ - 1 && chunkLOD[i + chunkCountX] > lod) mask |= STITCH_BOTTOM;
+        if (x > 0 && chunkLOD[i - 1] > lod) mask |= STITCH_LEFT;
+        return mask;
+    }
+
+    // 设置 terrain.vs 重建顶点位置 / UV 所需的 uniform
+    void setGridUniforms(Shader& shader) const
+    {
+        shader.setInt("uChunkSize", chunkSize);
+        shader.setInt("uChunkCountX", chunkCountX);
+        shader.setFloat("uGridScale", gridScale);
+        shader.setFloat("uHeightScale", heightmap.heightScale);
+        shader.setFloat("uSkirtDepth", TERRAIN_SKIRT_DEPTH);
+
+        float halfW = (heightmap.width - 1) * gridScale * 0.5f;
+        float halfH = (heightmap.height - 1) * gridScale * 0.5f;
+        shader.setVec2("uHalfExtent", glm::vec2(halfW, halfH));
+        shader.setVec2("uInvGridSize", glm::vec2(1.0f / (heightmap.width - 1), 1.0f / (heightmap.height - 1)));
+        shader.setVec2("uInvTexSize", glm::vec2(1.0f / heightmap.width, 1.0f / heightmap.height));
+    }
+
+    // 当前上下文是否支持细分着色器
+    static bool tessellationSupported()
+    {
+        GLint major = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        return major >= 4;
+    }
+
+    // 细分模式的绘制：每个可见 chunk 切成 P x P 个 patch（每 patch 不超过 16 个单元，最大细分级别即单元数）
+    void drawTessellated(Shader& shader, const glm::vec3& cameraPos)
+    {
+        const int cells = chunkSize - 1;
+        int patchesPerSide = 1;
+        while (cells / patchesPerSide > 16 && cells % (patchesPerSide * 2) == 0) patchesPerSide *= 2;
+
+        shader.setInt("uPatchesPerSide", patchesPerSide);
+        shader.setFloat("uMaxTess", (float)(cells / patchesPerSide));
+        shader.setFloat("uTessPixels", tessPixels);
+        shader.setFloat("uProjScale", lodProjScale);
+        shader.setVec3("uCameraPos", cameraPos);
+
+        instancer.begin();
+        for (int i : visibleChunks) instancer.add(i, 0, 0, TerrainIndexRange());
+
+        instancer.bindTextures();
+        instancer.flushPatches(4 * patchesPerSide * patchesPerSide);
+    }
+
+    // ==================== LOD 选择逻辑 ====================
+    int pickLOD(const TerrainChunk& chunk, const glm::vec3& cameraPos) const
+    {
+        if (lodMetric == TerrainLODMetric::Distance)
+            return pickLOD(glm::distance(cameraPos, chunk.getCenter()));
+
+        // 到 AABB 的最近距离（相机在盒内时取 1，避免除零）
+        const AABB box = chunk.getAABBWorld();
+        glm::vec3 closest = glm::clamp(cameraPos, box.min, box.max);
+        float distance = std::max(glm::distance(cameraPos, closest), 1.0f);
+
+        // 允许的世界误差；取满足容差的最粗 LOD
+        float maxError = lodPixelError * distance / lodProjScale;
+        int lod = 0;
+        while (lod + 1 < TerrainIndexBuffer::LOD_COUNT && chunk.getLODError(lod + 1) <= maxError) ++lod;
+        return lod;
+    }
+
     int pickLOD(float distance) const
     {
         if (distance < lod0Distance)
@@ -209,17 +979,67 @@ private:
 
 private:
     Heightmap& heightmap;
+
+    // 共享索引必须先于 chunks 构造、晚于 chunks 析构
+    TerrainIndexBuffer indexBuffer;
+    TerrainNormalField normalField;
     std::vector<TerrainChunk> chunks;
 
+    // chunk 网格尺寸与层次裁剪
+    int chunkSize;
+    int chunkCountX;
+    int chunkCountZ;
+    TerrainQuadtree quadtree;
+    std::vector<int> visibleChunks; // 每帧复用，避免重复分配
+
+    // 地平线遮挡：chunk bounds（按 chunk 下标）、地表足迹、每帧统计
+    std::vector<AABB> chunkBounds;
+    std::vector<AABB> chunkGround;
+    TerrainHorizonCuller horizonCuller;
+    TerrainOcclusionStats occlusionStats;
+    bool occlusionCulling = true;
+
+    // 接缝处理；缝合模式下每帧的 chunk LOD（按 chunk 下标）
+    TerrainSeamMode seamMode = TerrainSeamMode::Skirts;
+    std::vector<int> chunkLOD;
+
+    // 批量模式的大 VBO 与每帧绘制列表
+    TerrainBatch batch;
+    TerrainRenderMode renderMode = TerrainRenderMode::MultiDraw;
+
+    // 分页模式的调度器；引用 chunks / indexBuffer，必须先于它们析构
+    std::unique_ptr<TerrainPager> pager;
+
+    // 实例化（VTF）模式的纹理与实例缓冲；chunksBuilt 表示 chunk 顶点是否已生成
+    TerrainInstancer instancer;
+    bool chunksBuilt = false;
+
+    // 细分模式（与实例化模式共用 instancer 的纹理与实例缓冲）
+    float tessPixels = 4.0f;
+
+    // 地形编辑：等待重建顶点的 chunk（先进先出）及其标记，每帧的重建时间预算
+    std::vector<int> dirtyChunks;
+    std::vector<char> chunkDirty;
+    std::vector<int> editedChunks;
+    std::vector<int> rebuildScratch;
+    float editBudgetMs = 2.0f;
+
     Frustum frustum;
 
     float gridScale;
 
-    // LOD ֵ絥λ
+    // LOD 选择：屏幕空间误差容差（像素）与本帧的投影系数
+    TerrainLODMetric lodMetric = TerrainLODMetric::ScreenSpaceError;
+    float lodPixelError = 2.0f;
+    float lodProjScale = 1.0f;
+
+    // LOD 距离阈值（世界单位）
     float lod0Distance = 200.0f;
     float lod1Distance = 600.0f;
     float lod2Distance = 1400.0f;
 
     float worldSizeX;
     float worldSizeZ;
+
+    TerrainRaycaster raycaster;
 };
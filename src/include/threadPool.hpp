@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <atomic>
+#include <memory>
+
+// ====================== ThreadPool ======================
+// 固定数量的工作线程 + 任务队列。
+// - submit：提交任意任务，返回 future
+// - parallelFor：把 [begin, end) 切成小块分给工作线程，调用线程也参与，全部完成后返回
+// 地形 / 植被等启动期的 CPU 重活都走 ThreadPool::shared()。
+// ========================================================
+class ThreadPool {
+public:
+    // threadCount 为 0 时取硬件线程数 - 1（留一个给主线程）
+    explicit ThreadPool(unsigned threadCount = 0) {
+        if (threadCount == 0) {
+            unsigned hw = std::thread::hardware_concurrency();
+            threadCount = (hw > 1) ? hw - 1 : 1;
+        }
+
+        workers.reserve(threadCount);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // 工作线程数量（不含调用线程）
+    unsigned size() const { return (unsigned)workers.size(); }
+
+    // 提交一个任务，返回其结果的 future
+    template <class F>
+    auto submit(F&& f) -> std::future<decltype(f())> {
+        using R = decltype(f());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task] { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    // 并行执行 fn(i)，i ∈ [begin, end)；grain 为每次领取的下标个数
+    // 调用线程只等“已领取的下标全部做完”，不等辅助任务本身：辅助任务排在队列里其它长任务
+    // （如分页的后台构建）之后时，调用线程会自己做完所有下标直接返回，迟到的辅助任务领不到下标即退出
+    void parallelFor(int begin, int end, const std::function<void(int)>& fn, int grain = 1) {
+        if (end <= begin) return;
+        if (grain < 1) grain = 1;
+
+        struct Shared {
+            std::atomic<int> next;
+            std::atomic<int> completed{ 0 };
+            std::mutex mutex;
+            std::condition_variable cv;
+        };
+        auto shared = std::make_shared<Shared>();
+        shared->next = begin;
+        const int total = end - begin;
+        const std::function<void(int)>* body = &fn;
+
+        // 只有领到下标时才会访问 fn（此时调用线程必然还在等待）
+        auto worker = [shared, end, grain, total, body] {
+            for (;;) {
+                int i0 = shared->next.fetch_add(grain);
+                if (i0 >= end) break;
+                int i1 = (i0 + grain < end) ? i0 + grain : end;
+                for (int i = i0; i < i1; ++i) (*body)(i);
+                if (shared->completed.fetch_add(i1 - i0) + (i1 - i0) == total) {
+                    std::lock_guard<std::mutex> lock(shared->mutex);
+                    shared->cv.notify_all();
+                }
+            }
+        };
+
+        // 工作线程与调用线程一起领取下标
+        int chunks = (total + grain - 1) / grain;
+        int helpers = (int)size() < chunks - 1 ? (int)size() : chunks - 1;
+        for (int h = 0; h < helpers; ++h) submit(worker);
+
+        worker();
+        std::unique_lock<std::mutex> lock(shared->mutex);
+        shared->cv.wait(lock, [&] { return shared->completed.load() == total; });
+    }
+
+    // 全局共享线程池
+    static ThreadPool& shared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+private:
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
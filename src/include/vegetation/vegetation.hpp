@@ -6,9 +6,9 @@
 #include "include/terrain/terrain.hpp"
 
 // ============================================================
-// CreateDefaultVegetationManager (° VegetationManager)
-// - ʹø߶/¶Լֲֻأ
-// - ܶԣܡҶеȡҶϡ衢ľ
+// CreateDefaultVegetationManager (适配新版 VegetationManager)
+// - 不使用高度/坡度约束：只做随机种植（贴地）
+// - 密度与间距策略：果树略密、阔叶中等、针叶稀疏、灌木更密
 // ============================================================
 inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
     Terrain& terrain,
@@ -25,9 +25,9 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
     const std::string treeDir = std::string(ASSETS_FOLDER) + "vegetation/trees/";
 
     // =========================================================
-    //  / ͥԺܣ
-    // - density Ը
-    // - spacing СҪֹ԰۸У
+    // 果树 / 庭院树（略密）
+    // - density 稍高
+    // - spacing 稍小（但仍要保持果园观感）
     // =========================================================
     veg->addSpecies(VegetationManager::Species(
         "AppleTree",
@@ -36,7 +36,7 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         treeDir,
         26.0f,          // targetHeight
         0.90f, 1.10f,   // scale jitter
-        0.000080f,      // densityܣ
+        0.000080f,      // density（略密）
         14.0f           // minSpacing
     ));
 
@@ -63,9 +63,9 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
     ));
 
     // =========================================================
-    // Ҷ֣еȣ
-    // - density е
-    // - spacing е
+    // 阔叶林（中等）
+    // - density 中等
+    // - spacing 中等
     // =========================================================
     veg->addSpecies(VegetationManager::Species(
         "Birch1",
@@ -74,7 +74,7 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         treeDir,
         30.0f,
         0.85f, 1.15f,
-        0.000048f,   // е
+        0.000048f,   // 中等
         16.0f
     ));
 
@@ -122,7 +122,7 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         17.0f
     ));
 
-     // ӻ green_tree2 / green_tree_3ҶеȲڣԵ density ⡰ˢǽ
+     // 加回 green_tree2 / green_tree_3（阔叶中等策略内，略低 density 避免“刷墙”）
     veg->addSpecies(VegetationManager::Species(
         "GreenTree2",
         Type::DeciduousTree,
@@ -146,9 +146,9 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
     ));
 
     // =========================================================
-    // Ҷ֣ϡ裩
-    // - density 
-    // - spacing ͻ׺/֡Ч
+    // 针叶林（稀疏）
+    // - density 更低
+    // - spacing 更大（突出“点缀/疏林”效果）
     // =========================================================
     veg->addSpecies(VegetationManager::Species(
         "FirTree",
@@ -157,14 +157,14 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         treeDir,
         42.0f,
         0.90f, 1.20f,
-        0.000042f,   // ϡ
+        0.000042f,   // 稀疏
         22.0f
     ));
 
     // =========================================================
-    // ľ / ²㣨ܣ
-    // - density 
-    // - spacing С
+    // 灌木 / 林下层（更密）
+    // - density 更高
+    // - spacing 更小
     // =========================================================
     veg->addSpecies(VegetationManager::Species(
         "HollyShrub",
@@ -173,7 +173,7 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         treeDir,
         6.0f,
         0.90f, 1.25f,
-        0.000190f,   // 
+        0.000190f,   // 更密
         6.0f
     ));
 
@@ -189,13 +189,13 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
     //));
 
     // =========================================================
-//  / ݣGroundCoverڡԲλƺ
+// 花 / 草（GroundCover）——用于“圆形花坪”
 // =========================================================
     const std::string flowerDir = std::string(ASSETS_FOLDER) + "vegetation/flowers/";
     std::vector<int> bedSpecies;
     bedSpecies.reserve(6);
 
-    // Ŀ߶Ҫģʵʳ߶΢һסܺܡĬֵ
+    // 目标高度与间距需要根据模型实际尺度微调：以下是一套“先能很密”的默认值
     bedSpecies.push_back(veg->addSpecies(VegetationManager::Species(
         "ColoredFlower",
         Type::GroundCover,
@@ -203,7 +203,7 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
         flowerDir,
         0.55f,          // targetHeight
         0.85f, 1.15f,
-        1.0f,           // density Իƺɺǿ
+        1.0f,           // density 对花坪生成函数不强依赖，可随意
         0.55f           // minSpacing
     )));
 
@@ -264,20 +264,20 @@ inline std::unique_ptr<VegetationManager> CreateDefaultVegetationManager(
 
 
     // =========================================================
-    // ʼ & 
+    // 初始化 & 生成
     // =========================================================
     veg->initModels();
     veg->generate(terrain, seed, worldMinX, worldMaxX, worldMinZ, worldMaxZ);
 
-    // --- ɻƺԲΣ---
+    // --- 生成花坪（圆形）---
     veg->generateFlowerBedCircle(
         terrain,
-        seed + 999,      //  seed
+        seed + 999,      // 独立 seed
         flowerBedCenter,
         flowerBedRadius,
         bedSpecies,
-        0.7f,           // ʣԽԽ桱
-        90               // ԴԽԽܵɸ
+        0.7f,           // 覆盖率：越大越“看不到地面”
+        90               // 重试次数：越大越密但生成更慢
     );
 
 
@@ -0,0 +1,226 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "../shader.hpp"
+#include "../model.hpp"
+
+// 每个 impostor 实例的参数（实例属性 3 / 4）
+struct ImpostorInstance {
+    glm::vec3 center;   // 模型 AABB 中心的世界坐标
+    float radius;       // 世界空间包围球半径
+    float yaw;          // 绕 Y 轴的朝向（与网格实例的 yaw 相同）
+};
+
+// ====================== VegetationImpostor ======================
+// 八面体 impostor：加载时把一个物种的模型从上半球 frames x frames 个方向（半八面体映射均匀铺开）
+// 正交渲染进图集，每个方向一格：
+//   - albedo 图集：rgb 为反照率，a 为覆盖率
+//   - normalDepth 图集：rgb 为模型空间法线，a 为沿该方向的线性深度（0 ~ 4 * 半径）
+// 两张图集的 rgb / 深度都乘过覆盖率（背景为 0），mip 平均后除以 a 即可还原，边缘不会发黑。
+// 远处实例只画一个朝向相机的 quad：顶点着色器按相机在模型空间的方向选最近的一格，
+// 把 quad 投影到该格的成像平面上取 uv；片元着色器按深度写回 gl_FragDepth，与地形正确穿插。
+// ================================================================
+class VegetationImpostor {
+public:
+    VegetationImpostor() = default;
+    ~VegetationImpostor() { release(); }
+
+    VegetationImpostor(const VegetationImpostor&) = delete;
+    VegetationImpostor& operator=(const VegetationImpostor&) = delete;
+
+    // 用 bakeShader 把 model（按 getNormalizeTransform 归一化、未缩放）渲染进 frames x frames 格、每格 cellPixels 的图集
+    void bake(Model& model, Shader& bakeShader, int frames, int cellPixels);
+    void release();
+    bool isBaked() const { return albedoTexture != 0; }
+
+    // 上传实例并一次 glDrawArraysInstanced 画出全部 quad（shader 须已 use 并设好 view / projection / 光照）
+    void draw(Shader& shader, const std::vector<ImpostorInstance>& instances);
+
+    // 半八面体映射：上半球单位方向 <-> [-1, 1]^2（与 impostor.vs 相同）
+    static glm::vec2 hemiOctEncode(const glm::vec3& d);
+    static glm::vec3 hemiOctDecode(const glm::vec2& uv);
+
+private:
+    int frames = 0;
+    unsigned int albedoTexture = 0;
+    unsigned int normalDepthTexture = 0;
+    unsigned int VAO = 0;
+    unsigned int instanceVBO = 0;
+    size_t capacity = 0;
+};
+
+// --------------------------- 实现 ---------------------------
+
+inline glm::vec2 VegetationImpostor::hemiOctEncode(const glm::vec3& d) {
+    glm::vec2 p = glm::vec2(d.x, d.z) / (std::fabs(d.x) + std::fabs(d.y) + std::fabs(d.z));
+    return glm::vec2(p.x + p.y, p.x - p.y);
+}
+
+inline glm::vec3 VegetationImpostor::hemiOctDecode(const glm::vec2& uv) {
+    glm::vec2 p = glm::vec2(uv.x + uv.y, uv.x - uv.y) * 0.5f;
+    return glm::normalize(glm::vec3(p.x, 1.0f - std::fabs(p.x) - std::fabs(p.y), p.y));
+}
+
+inline void VegetationImpostor::bake(Model& model, Shader& bakeShader, int inFrames, int cellPixels) {
+    if (isBaked() || !model.aabbValid || inFrames <= 0 || cellPixels <= 0) return;
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto t0 = Clock::now();
+
+    frames = inFrames;
+    const int size = frames * cellPixels;
+
+    // 归一化后模型 x / z 居中、y 落在 [0, h]：再平移到包围球中心
+    const glm::vec3 extent = model.getAabbSize();
+    const float radius = 0.5f * glm::length(extent);
+    const glm::mat4 base = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, -0.5f * extent.y, 0.0f))
+        * model.getNormalizeTransform(true, true);
+
+    auto makeAtlas = [size](unsigned int& tex) {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        };
+    makeAtlas(albedoTexture);
+    makeAtlas(normalDepthTexture);
+
+    unsigned int fbo = 0, depthRBO = 0;
+    glGenFramebuffers(1, &fbo);
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, size, size);
+
+    // 保存会被改动的状态
+    GLint prevFBO = 0, prevViewport[4];
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &prevFBO);
+    glGetIntegerv(GL_VIEWPORT, prevViewport);
+    GLboolean prevBlend = glIsEnabled(GL_BLEND);
+    GLboolean prevCull = glIsEnabled(GL_CULL_FACE);
+    GLboolean prevDepth = glIsEnabled(GL_DEPTH_TEST);
+    GLfloat prevClear[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, prevClear);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, albedoTexture, 0);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, normalDepthTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+    const GLenum buffers[2] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+    glDrawBuffers(2, buffers);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "VegetationImpostor: bake framebuffer incomplete" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteRenderbuffers(1, &depthRBO);
+        release();
+        return;
+    }
+
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glEnable(GL_DEPTH_TEST);
+    glViewport(0, 0, size, size);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    bakeShader.use();
+    bakeShader.setMat4("uProjection", glm::ortho(-radius, radius, -radius, radius, 0.0f, 4.0f * radius));
+    bakeShader.setFloat("uDepthRange", 4.0f * radius);
+
+    // 第 (i, j) 格：格心的半八面体坐标解码出观察方向，相机在该方向 2 * 半径处看向中心
+    for (int j = 0; j < frames; ++j) {
+        for (int i = 0; i < frames; ++i) {
+            glm::vec2 uv = (glm::vec2(i, j) + 0.5f) / (float)frames * 2.0f - 1.0f;
+            glm::vec3 dir = hemiOctDecode(uv);
+            glm::vec3 right = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), dir);
+            right = (glm::dot(right, right) < 1e-8f) ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::normalize(right);
+            glm::vec3 up = glm::cross(dir, right);
+
+            glViewport(i * cellPixels, j * cellPixels, cellPixels, cellPixels);
+            bakeShader.setMat4("uView", glm::lookAt(dir * (2.0f * radius), glm::vec3(0.0f), up));
+            model.Draw(bakeShader, base);
+        }
+    }
+
+    // 恢复状态
+    glBindFramebuffer(GL_FRAMEBUFFER, prevFBO);
+    glViewport(prevViewport[0], prevViewport[1], prevViewport[2], prevViewport[3]);
+    glClearColor(prevClear[0], prevClear[1], prevClear[2], prevClear[3]);
+    if (prevBlend) glEnable(GL_BLEND);
+    if (prevCull) glEnable(GL_CULL_FACE);
+    if (!prevDepth) glDisable(GL_DEPTH_TEST);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &depthRBO);
+
+    // mip 只做到每格 8 像素，避免相邻格互相渗色
+    int maxLevel = 0;
+    while ((cellPixels >> (maxLevel + 1)) >= 8) ++maxLevel;
+    for (unsigned int tex : { albedoTexture, normalDepthTexture }) {
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, maxLevel);
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // 实例 VAO：没有顶点属性，quad 的四个角由 gl_VertexID 生成
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &instanceVBO);
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(ImpostorInstance), (void*)0);
+    glVertexAttribDivisor(3, 1);
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(ImpostorInstance), (void*)offsetof(ImpostorInstance, yaw));
+    glVertexAttribDivisor(4, 1);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+    std::cout << "[Impostor] Baked " << frames << "x" << frames << " views into " << size << "x" << size
+        << " atlas (" << (((size_t)size * size * 8 * 4 / 3) >> 10) << " KB) in " << ms << " ms" << std::endl;
+}
+
+inline void VegetationImpostor::draw(Shader& shader, const std::vector<ImpostorInstance>& instances) {
+    if (!isBaked() || instances.empty()) return;
+
+    shader.setFloat("uFrames", (float)frames);
+    shader.setInt("uAlbedo", 0);
+    shader.setInt("uNormalDepth", 1);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, albedoTexture);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, normalDepthTexture);
+
+    // 先孤立旧存储，避免与上一帧的绘制同步
+    capacity = std::max(capacity, instances.size());
+    glBindVertexArray(VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(ImpostorInstance), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, instances.size() * sizeof(ImpostorInstance), instances.data());
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, (GLsizei)instances.size());
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+inline void VegetationImpostor::release() {
+    if (albedoTexture != 0) glDeleteTextures(1, &albedoTexture);
+    if (normalDepthTexture != 0) glDeleteTextures(1, &normalDepthTexture);
+    if (VAO != 0) glDeleteVertexArrays(1, &VAO);
+    if (instanceVBO != 0) glDeleteBuffers(1, &instanceVBO);
+    albedoTexture = normalDepthTexture = VAO = instanceVBO = 0;
+    capacity = 0;
+    frames = 0;
+}
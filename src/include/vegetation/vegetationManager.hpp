@@ -5,6 +5,10 @@
 #include <unordered_map>
 #include <memory>
 #include <cmath>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,6 +16,8 @@
 #include "../shader.hpp"
 #include "../model.hpp"
 #include "../terrain/terrain.hpp"
+#include "../threadPool.hpp"
+#include "vegetationImpostor.hpp"
 
 class VegetationManager {
 public:
@@ -30,20 +36,20 @@ public:
         std::string modelPath;
         std::string textureDir;
 
-        // ͳһ߶ȣģ͸߶ȹһ targetHeight
+        // 统一尺度：把模型高度归一到 targetHeight
         float targetHeight = 35.0f;
 
-        // Ŷ
+        // 随机缩放扰动
         float minScaleJitter = 0.85f;
         float maxScaleJitter = 1.20f;
 
-        // ֲ
-        float density = 0.00008f;  // ÿƽλĸӣƣ
-        float minSpacing = 12.0f;  // Сࣩࣨͬ
+        // 分布参数
+        float density = 0.00008f;  // “每平方单位”的概率因子（近似）
+        float minSpacing = 12.0f;  // 最小间距（同类）
 
         Species() = default;
 
-        // ʽ죺 vegetation.hpp ֱ VegetationManager::Species(...)
+        // 显式构造：便于在 vegetation.hpp 里直接 VegetationManager::Species(...)
         Species(
             std::string inName,
             SpeciesType inType,
@@ -75,9 +81,20 @@ public:
         glm::vec3 pos{ 0.0f };
         float yawRad = 0.0f;
         float uniformScale = 1.0f;
+        int slot = -1;      // 在所属物种的预计算矩阵数组中的下标
     };
 
 public:
+    VegetationManager() = default;
+    VegetationManager(const VegetationManager&) = delete;
+    VegetationManager& operator=(const VegetationManager&) = delete;
+
+    ~VegetationManager() {
+        for (auto& batch : batches_) {
+            if (batch.instanceVBO != 0) glDeleteBuffers(1, &batch.instanceVBO);
+        }
+    }
+
     int addSpecies(const Species& sp) {
         species_.push_back(sp);
         return (int)species_.size() - 1;
@@ -91,63 +108,139 @@ public:
         for (const auto& sp : species_) {
             models_.push_back(std::make_unique<Model>(sp.modelPath, sp.textureDir));
         }
+
+        // 每个物种一个实例矩阵缓冲，挂到该物种模型的所有 mesh 上
+        for (auto& batch : batches_) {
+            if (batch.instanceVBO != 0) glDeleteBuffers(1, &batch.instanceVBO);
+        }
+        batches_.assign(species_.size(), SpeciesBatch{});
+        for (size_t si = 0; si < species_.size(); ++si) {
+            glGenBuffers(1, &batches_[si].instanceVBO);
+            models_[si]->setInstanceBuffer(batches_[si].instanceVBO);
+        }
+
+        // 先 generate 后 initModels：已放置的实例按真实模型 AABB 重新烘焙矩阵与包围盒
+        if (!instances_.empty()) rebuildSpatialIndex_();
+
+        // 树：预渲染八面体 impostor 图集
+        impostors_.clear();
+        impostors_.resize(species_.size());
+        impostorShader_.reset();
+        if (impostorFrames_ <= 0) return;
+
+        std::unique_ptr<Shader> bakeShader;
+        for (size_t si = 0; si < species_.size(); ++si) {
+            if (!usesImpostor_(species_[si].type)) continue;
+            if (!bakeShader) {
+                bakeShader = std::make_unique<Shader>(SHADERS_FOLDER "impostor_bake.vs", SHADERS_FOLDER "impostor_bake.fs");
+                impostorShader_ = std::make_unique<Shader>(SHADERS_FOLDER "impostor.vs", SHADERS_FOLDER "impostor.fs");
+            }
+            impostors_[si] = std::make_unique<VegetationImpostor>();
+            impostors_[si]->bake(*models_[si], *bakeShader, impostorFrames_, impostorCellPixels_);
+        }
+    }
+
+    // 平行光（direction 从光源指向地面）：render 时同时设给网格 shader 与 impostor shader
+    void setLight(const glm::vec3& direction, const glm::vec3& color) {
+        lightDirection_ = direction;
+        lightColor_ = color;
+    }
+
+    // impostor：树在 startDistance 之外改画 impostor，一直画到 maxDistance
+    void setImpostorDistances(float startDistance, float maxDistance) {
+        impostorDistance_ = std::max(startDistance, 0.0f);
+        impostorMaxDistance_ = std::max(maxDistance, impostorDistance_);
     }
 
-    // ãֻ + ܶ + С
+    // impostor 图集为 frames x frames 个方向、每格 cellPixels 像素；须在 initModels 之前设置，frames <= 0 关闭 impostor
+    void setImpostorResolution(int frames, int cellPixels) {
+        impostorFrames_ = frames;
+        impostorCellPixels_ = cellPixels;
+    }
+
+    // 纯随机布置：只贴地 + 密度 + 最小间距
+    // 世界按采样点切成 tile 并行生成，每个 (tile, 物种) 一条独立的计数器式随机序列；
+    // tile 按 2x2 奇偶分四轮，同一轮的 tile 互不相邻、可并行，跨 tile 的间距冲突
+    // 由“先轮次的实例优先”裁决。结果只取决于 seed 与世界范围，与线程数、调度顺序无关
     void generate(const Terrain& terrain,
         int seed,
         float worldMinX, float worldMaxX,
         float worldMinZ, float worldMaxZ)
     {
+        using Clock = std::chrono::high_resolution_clock;
+        auto t0 = Clock::now();
+
         instances_.clear();
-        spacingGrid_.clear();
-        rng_.seed(seed);
 
-        // ͳһ񲽳ȡ minSpacing һ׼
+        // 统一采样网格步长：取所有物种 minSpacing 的一个合理基准
         float baseStep = 8.0f;
         for (const auto& sp : species_) {
             baseStep = std::min(baseStep, sp.minSpacing * 0.5f);
         }
         baseStep = glm::clamp(baseStep, 2.0f, 14.0f);
 
-        for (float z = worldMinZ; z <= worldMaxZ; z += baseStep) {
-            for (float x = worldMinX; x <= worldMaxX; x += baseStep) {
-
-                for (int si = 0; si < (int)species_.size(); ++si) {
-                    const Species& sp = species_[si];
-
-                    if (sp.type == SpeciesType::GroundCover) {
-                        continue;
-                    }
+        // 采样点按下标取坐标（不再逐步累加浮点数）
+        const int samplesX = (int)std::floor((worldMaxX - worldMinX) / baseStep) + 1;
+        const int samplesZ = (int)std::floor((worldMaxZ - worldMinZ) / baseStep) + 1;
+        if (samplesX <= 0 || samplesZ <= 0) {
+            rebuildSpatialIndex_();
+            return;
+        }
 
-                    //  density תÿĽܸʣƣdensity * cellArea
-                    float p = glm::clamp(sp.density * baseStep * baseStep, 0.0f, 0.4f);
-                    if (rand01_() > p) continue;
+        // tile 边长（采样点数）：同一轮的两个 tile 之间隔着一整个 tile，
+        // 扣掉两侧各半步的抖动后仍不小于最大间距，因此不会互相冲突
+        float maxSpacing = 0.0f;
+        for (const auto& sp : species_) {
+            if (sp.type != SpeciesType::GroundCover) maxSpacing = std::max(maxSpacing, sp.minSpacing);
+        }
+        const int tileSamples = std::max(GEN_TILE_SAMPLES, (int)std::ceil(maxSpacing / baseStep));
+        // 所有物种共用的间距格子：边长取最大间距，3x3 邻域即可覆盖任一物种的间距半径
+        const float spacingCell = std::max(maxSpacing, 1.0f);
+        const int tilesX = (samplesX + tileSamples - 1) / tileSamples;
+        const int tilesZ = (samplesZ + tileSamples - 1) / tileSamples;
+
+        std::vector<GenTile> tiles((size_t)tilesX * tilesZ);
+        std::vector<int> rounds[4];
+        for (int tz = 0; tz < tilesZ; ++tz) {
+            for (int tx = 0; tx < tilesX; ++tx) {
+                GenTile& tile = tiles[(size_t)tz * tilesX + tx];
+                tile.tx = tx;
+                tile.tz = tz;
+                tile.ix0 = tx * tileSamples;
+                tile.ix1 = std::min(tile.ix0 + tileSamples, samplesX);
+                tile.iz0 = tz * tileSamples;
+                tile.iz1 = std::min(tile.iz0 + tileSamples, samplesZ);
+                rounds[(tx & 1) | ((tz & 1) << 1)].push_back(tz * tilesX + tx);
+            }
+        }
 
-                    // 
-                    float px = x + (rand01_() - 0.5f) * baseStep;
-                    float pz = z + (rand01_() - 0.5f) * baseStep;
+        for (const auto& round : rounds) {
+            ThreadPool::shared().parallelFor(0, (int)round.size(), [&](int k) {
+                generateTile_(tiles, tilesX, tilesZ, round[k], seed, baseStep, spacingCell, worldMinX, worldMinZ);
+            });
+        }
 
-                    // 
-                    float py = terrain.getHeightWorld(px, pz);
+        // 按 tile 顺序合并
+        size_t total = 0;
+        for (const auto& tile : tiles) total += tile.placed.size();
+        instances_.reserve(total);
+        for (const auto& tile : tiles) {
+            instances_.insert(instances_.end(), tile.placed.begin(), tile.placed.end());
+        }
+        tiles.clear();
 
-                    // Сˣࣩͬ
-                    if (!checkSpacing_(sp, { px, py, pz })) continue;
+        // 贴地
+        snapToTerrain_(terrain, 0);
 
-                    Instance inst;
-                    inst.speciesIndex = si;
-                    inst.pos = { px, py, pz };
-                    inst.yawRad = rand01_() * glm::two_pi<float>();
-                    inst.uniformScale = randRange_(sp.minScaleJitter, sp.maxScaleJitter);
+        rebuildSpatialIndex_();
 
-                    instances_.push_back(inst);
-                    addToSpacingGrid_(sp, inst.pos);
-                }
-            }
-        }
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        std::cout << "[Vegetation] Generated " << instances_.size() << " instances in "
+            << tilesX << "x" << tilesZ << " tiles in " << ms << " ms" << std::endl;
     }
 
-    // ע⣺Model::Draw  const render Ҳ const Model ǰ£
+    // 按物种实例化绘制：可见实例的世界矩阵按物种收集进各自的实例缓冲，
+    // 每个物种的每个 mesh 一次 glDrawElementsInstanced（draw call 数 = 物种 x mesh，与实例数无关）
     void render(const Terrain&,
         Shader& shader,
         const glm::mat4& view,
@@ -157,60 +250,146 @@ public:
         shader.use();
         shader.setMat4("view", view);
         shader.setMat4("projection", projection);
+        shader.setVec3("viewPos", cameraPos);
+        shader.setVec3("light.direction", lightDirection_);
+        shader.setVec3("light.color", lightColor_);
 
-        for (const auto& inst : instances_) {
-            const Species& sp = species_[inst.speciesIndex];
-            Model& model = *models_[inst.speciesIndex];
-
-            // 򵥾ü
-            float maxDist = 800.0f;
-            switch (sp.type) {
-            case SpeciesType::GroundCover: maxDist = 140.0f; break;
-            case SpeciesType::Shrub:       maxDist = 250.0f; break;
-            default:                       maxDist = 800.0f; break;
+        for (auto& batch : batches_) {
+            batch.matrices.clear();
+            batch.impostors.clear();
+        }
+
+        // 先按格子裁剪（距离 + 视锥），只有留下的格子里的实例才会被访问：
+        //   - 格子完全在视锥内且整格都在网格 / impostor 距离段内：各物种的预计算数据整段拷贝
+        //   - 格子完全在视锥内：整段收下，逐个做距离判断
+        //   - 格子与视锥相交：对这段实例做 SoA 批量测试
+        // 有 impostor 的树格子绘制距离延长到 impostorMaxDistance_
+        Frustum frustum;
+        frustum.updateFromMatrix(projection * view);
+        visibleInstances_.clear();
+        for (const Cell& cell : cells_) {
+            const bool impostorCell = cell.trees && impostorShader_;
+            const float limit = impostorCell ? std::max(cell.maxDist, impostorMaxDistance_) : cell.maxDist;
+
+            glm::vec3 nearest = glm::clamp(cameraPos, cell.bounds.min, cell.bounds.max);
+            glm::vec3 toCell = nearest - cameraPos;
+            float nearest2 = glm::dot(toCell, toCell);
+            if (nearest2 > limit * limit) continue;
+
+            unsigned planeMask = 0x3F;
+            Frustum::Containment c = frustum.classify(cell.bounds, planeMask);
+            if (c == Frustum::Containment::Outside) continue;
+            if (c == Frustum::Containment::Inside) {
+                glm::vec3 farthest = glm::max(cameraPos - cell.bounds.min, cell.bounds.max - cameraPos);
+                float farthest2 = glm::dot(farthest, farthest);
+
+                // 整格都画网格
+                float meshDist = impostorCell ? std::min(cell.maxDist, impostorDistance_) : cell.maxDist;
+                if (farthest2 <= meshDist * meshDist) {
+                    for (int r = cell.firstRun; r < cell.firstRun + cell.runCount; ++r) {
+                        const Run& run = runs_[r];
+                        appendRange_(batches_[run.species].matrices, speciesMatrices_[run.species], run.first, run.count);
+                    }
+                    continue;
+                }
+
+                // 整格都画 impostor（没有图集的物种仍逐个判断）
+                if (impostorCell && nearest2 >= impostorDistance_ * impostorDistance_ &&
+                    farthest2 <= impostorMaxDistance_ * impostorMaxDistance_) {
+                    int i = cell.first;
+                    for (int r = cell.firstRun; r < cell.firstRun + cell.runCount; ++r) {
+                        const Run& run = runs_[r];
+                        if (hasImpostor_(run.species)) {
+                            appendRange_(batches_[run.species].impostors, speciesImpostors_[run.species], run.first, run.count);
+                        }
+                        else {
+                            for (int k = 0; k < run.count; ++k) visibleInstances_.push_back(i + k);
+                        }
+                        i += run.count;
+                    }
+                    continue;
+                }
+
+                for (int i = cell.first; i < cell.first + cell.count; ++i) visibleInstances_.push_back(i);
             }
+            else {
+                frustum.intersectsBatch(instanceBounds_, cell.first, cell.first + cell.count, visibleInstances_);
+            }
+        }
+
+        for (int idx : visibleInstances_) {
+            const Instance& inst = instances_[idx];
+            const int si = inst.speciesIndex;
             glm::vec3 d = inst.pos - cameraPos;
-            if (glm::dot(d, d) > maxDist * maxDist) continue;
+            float dist2 = glm::dot(d, d);
 
-            // һ targetHeight
-            float h = model.getAabbHeight();
-            float scale = (h > 1e-6f) ? (sp.targetHeight / h) : 1.0f;
-            scale *= inst.uniformScale;
+            // 有 impostor 的树：impostorDistance_ 以内画网格，之外到 impostorMaxDistance_ 画 impostor
+            if (hasImpostor_(si)) {
+                if (dist2 <= impostorDistance_ * impostorDistance_) {
+                    batches_[si].matrices.push_back(speciesMatrices_[si][inst.slot]);
+                }
+                else if (dist2 <= impostorMaxDistance_ * impostorMaxDistance_) {
+                    batches_[si].impostors.push_back(speciesImpostors_[si][inst.slot]);
+                }
+                continue;
+            }
 
-            // 1. ģͿռ䣺һ + 
-            glm::mat4 local(1.0f);
-            local = local * glm::scale(glm::mat4(1.0f), glm::vec3(scale));
-            local = local * model.getNormalizeTransform(true, true);
+            // 简单距离裁剪
+            float maxDist = maxDrawDistance_(species_[si].type);
+            if (dist2 > maxDist * maxDist) continue;
 
-            // 2. ռ䣺ת + ƽ
-            glm::mat4 M(1.0f);
-            M = glm::translate(M, inst.pos);
-            M = glm::rotate(M, inst.yawRad, { 0, 1, 0 });
+            batches_[si].matrices.push_back(speciesMatrices_[si][inst.slot]);
+        }
 
-            // 3. ϳ
-            M = M * local;
+        // 逐物种上传实例矩阵并绘制（先孤立旧存储，避免与上一帧的绘制同步）
+        drawCount_ = 0;
+        for (size_t si = 0; si < batches_.size(); ++si) {
+            SpeciesBatch& batch = batches_[si];
+            if (batch.matrices.empty()) continue;
 
-            model.Draw(shader, M);
+            batch.capacity = std::max(batch.capacity, batch.matrices.size());
+            glBindBuffer(GL_ARRAY_BUFFER, batch.instanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, batch.capacity * sizeof(glm::mat4), nullptr, GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, batch.matrices.size() * sizeof(glm::mat4), batch.matrices.data());
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
 
+            drawCount_ += models_[si]->DrawInstanced(shader, (int)batch.matrices.size());
+        }
+
+        // impostor：每个物种一次 glDrawArraysInstanced，光照与网格相同
+        if (impostorShader_) {
+            Shader& impostorShader = *impostorShader_;
+            impostorShader.use();
+            impostorShader.setMat4("view", view);
+            impostorShader.setMat4("projection", projection);
+            impostorShader.setVec3("viewPos", cameraPos);
+            impostorShader.setVec3("light.direction", lightDirection_);
+            impostorShader.setVec3("light.color", lightColor_);
+
+            for (size_t si = 0; si < batches_.size(); ++si) {
+                if (batches_[si].impostors.empty()) continue;
+                impostors_[si]->draw(impostorShader, batches_[si].impostors);
+                ++drawCount_;
+            }
         }
     }
 
-    //  VegetationManager public: 
+    // 在 VegetationManager public: 里添加
     void generateFlowerBedCircle(
         const Terrain& terrain,
         int seed,
         const glm::vec2& centerXZ,
         float radius,
-        const std::vector<int>& speciesIndices,   // ϵ GroundCover ±
-        float targetCoverage = 0.92f,             // Ŀ긲ʣԽԽܣ
-        int maxTriesPerPoint = 20                 // ʧޣ
+        const std::vector<int>& speciesIndices,   // 参与混合的 GroundCover 物种下标
+        float targetCoverage = 0.92f,             // 目标覆盖率（越大越密）
+        int maxTriesPerPoint = 20                 // 失败重试上限，控制性能
     ) {
         if (speciesIndices.empty() || radius <= 0.0f) return;
 
-        // ʹö seedӰ generate() УҲ㸴֣
+        // 使用独立 seed，避免影响主 generate() 的随机序列（也方便复现）
         rng_.seed(seed);
 
-        // ҲС minSpacingܶȡ
+        // 找参与物种里最小 minSpacing，决定“理论最大密度”
         float smin = FLT_MAX;
         for (int idx : speciesIndices) {
             if (idx < 0 || idx >= (int)species_.size()) continue;
@@ -218,14 +397,14 @@ public:
         }
         if (smin == FLT_MAX) return;
 
-        // ĿԲ / (spacing^2) * coverageϵ
-        // coverage Խӽ 1Խӽ桱
+        // 估算目标数量：圆面积 / (spacing^2) * coverage系数
+        // coverage 越接近 1，越接近“几乎看不到地面”
         const float area = glm::pi<float>() * radius * radius;
         int targetCount = (int)std::ceil(area / (smin * smin) * targetCoverage);
 
 
-        // Ϊ˱ spacingGrid_ ֮ǰ cell size ţﲻ spacingGrid_
-        // һֲ gridֻԻƺʵԼ
+        // 为了避免 spacingGrid_ 被之前树的 cell size 干扰，这里不复用 spacingGrid_
+        // 采用一个局部 grid（只对花坪实例做间距约束）
         struct LocalCellKey { int x, z; bool operator==(const LocalCellKey& o) const { return x == o.x && z == o.z; } };
         struct LocalHash {
             size_t operator()(const LocalCellKey& k) const noexcept {
@@ -254,9 +433,10 @@ public:
             localGrid[cellOfLocal(cellSize, p)].push_back(p);
             };
 
-        // cellSize ȡ sminPoisson grid òԣ
+        // cellSize 取 smin（Poisson grid 常用策略）
         const float cellSize = smin;
 
+        const size_t firstNew = instances_.size();
         int placed = 0;
         int globalTries = 0;
         int globalTryLimit = targetCount * maxTriesPerPoint;
@@ -264,7 +444,7 @@ public:
         while (placed < targetCount && globalTries < globalTryLimit) {
             ++globalTries;
 
-            // ԲھȲr = sqrt(u)*R
+            // 圆内均匀采样：r = sqrt(u)*R
             float u = rand01_();
             float v = rand01_();
             float r = std::sqrt(u) * radius;
@@ -272,28 +452,27 @@ public:
 
             float px = centerXZ.x + r * std::cos(theta);
             float pz = centerXZ.y + r * std::sin(theta);
-            float py = terrain.getHeightWorld(px, pz);
 
-            // ѡһֲ֣ȻϣҲԸĳɴȨأ
+            // 随机选择一种参与物种（均匀混合；你也可以改成带权重）
             int pick = speciesIndices[(int)std::floor(rand01_() * speciesIndices.size()) % speciesIndices.size()];
             if (pick < 0 || pick >= (int)species_.size()) continue;
             const Species& sp = species_[pick];
 
-            // ˣʵݸܡϡ
+            // 做过滤（更真实：草更密、花略稀）
             float spacing = std::max(sp.minSpacing, 0.01f);
 
-            // ݣܣƣ
+            // 草：允许更密（甚至不限制）
             if (sp.name.find("Grass") != std::string::npos) {
-                spacing *= 0.85f;           // òݸܣЧ spacing ͣ
+                spacing *= 0.85f;           // 让草更密（等效 spacing 大幅降低）
             }
 
             if (spacing > 1e-6f) {
-                if (!checkLocal(cellSize, spacing, { px,py,pz })) continue;
+                if (!checkLocal(cellSize, spacing, { px,0.0f,pz })) continue;
             }
 
             Instance inst;
             inst.speciesIndex = pick;
-            inst.pos = { px, py, pz };
+            inst.pos = { px, 0.0f, pz };
             inst.yawRad = rand01_() * glm::two_pi<float>();
             inst.uniformScale = randRange_(sp.minScaleJitter, sp.maxScaleJitter);
 
@@ -301,13 +480,22 @@ public:
             addLocal(cellSize, inst.pos);
             ++placed;
         }
+
+        // 间距过滤只看 XZ，新放置的实例最后统一批量贴地
+        snapToTerrain_(terrain, firstNew);
+
+        rebuildSpatialIndex_();
     }
 
 
     size_t instanceCount() const { return instances_.size(); }
+    size_t cellCount() const { return cells_.size(); }
+
+    // 上一次 render 发出的 draw call 数
+    int drawCount() const { return drawCount_; }
 
 private:
-    // ---- spacing gridͬСࣩ----
+    // ---- spacing grid（同类最小间距）----
     struct CellKey {
         int x, z;
         bool operator==(const CellKey& o) const { return x == o.x && z == o.z; }
@@ -318,20 +506,21 @@ private:
                 ^ (std::hash<int>()(k.z) * 19349663u);
         }
     };
+    using SpacingGrid = std::unordered_map<CellKey, std::vector<glm::vec3>, CellKeyHash>;
 
-    CellKey cellOf_(const Species& sp, const glm::vec3& p) const {
-        float cs = std::max(sp.minSpacing, 1.0f);
-        return { int(std::floor(p.x / cs)), int(std::floor(p.z / cs)) };
+    static CellKey cellOf_(float cellSize, const glm::vec3& p) {
+        return { int(std::floor(p.x / cellSize)), int(std::floor(p.z / cellSize)) };
     }
 
-    bool checkSpacing_(const Species& sp, const glm::vec3& p) const {
-        float r2 = sp.minSpacing * sp.minSpacing;
-        CellKey c = cellOf_(sp, p);
+    // grid 中是否有点（不分物种）离 p 小于 minSpacing；cellSize 须不小于 minSpacing
+    static bool checkSpacing_(const SpacingGrid& grid, float cellSize, float minSpacing, const glm::vec3& p) {
+        float r2 = minSpacing * minSpacing;
+        CellKey c = cellOf_(cellSize, p);
 
         for (int dz = -1; dz <= 1; ++dz) {
             for (int dx = -1; dx <= 1; ++dx) {
-                auto it = spacingGrid_.find({ c.x + dx, c.z + dz });
-                if (it == spacingGrid_.end()) continue;
+                auto it = grid.find({ c.x + dx, c.z + dz });
+                if (it == grid.end()) continue;
                 for (const auto& q : it->second) {
                     glm::vec2 d(p.x - q.x, p.z - q.z);
                     if (glm::dot(d, d) < r2) return false;
@@ -341,8 +530,270 @@ private:
         return true;
     }
 
-    void addToSpacingGrid_(const Species& sp, const glm::vec3& p) {
-        spacingGrid_[cellOf_(sp, p)].push_back(p);
+    // ---- 计数器式随机数：第 n 个输出只由 (key, n) 决定，key 由 (seed, tile, 物种) 混合而来 ----
+    static uint64_t mix64_(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    struct CounterRng {
+        uint64_t key;
+        uint64_t counter = 0;
+
+        CounterRng(int seed, int tileX, int tileZ, int species) {
+            key = mix64_(((uint64_t)(uint32_t)seed << 32) | (uint32_t)species);
+            key = mix64_(key ^ (((uint64_t)(uint32_t)tileX << 32) | (uint32_t)tileZ));
+        }
+
+        // [0, 1)，24 位精度
+        float next01() {
+            uint64_t r = mix64_(key + 0x9E3779B97F4A7C15ull * ++counter);
+            return (float)(r >> 40) * (1.0f / 16777216.0f);
+        }
+        float range(float a, float b) { return a + (b - a) * next01(); }
+    };
+
+    // ---- 并行生成的 tile：采样下标 [ix0, ix1) x [iz0, iz1) 上放置的实例及其间距格子 ----
+    static constexpr int GEN_TILE_SAMPLES = 16;
+    struct GenTile {
+        int tx = 0, tz = 0;
+        int ix0 = 0, ix1 = 0, iz0 = 0, iz1 = 0;
+        std::vector<Instance> placed;
+        SpacingGrid grid;                   // 所有非地被物种共用
+    };
+
+    // 生成一个 tile：只写自己，只读相邻 tile（先前轮次已完成；后续轮次的尚为空）
+    void generateTile_(std::vector<GenTile>& tiles, int tilesX, int tilesZ, int index,
+        int seed, float baseStep, float spacingCell, float worldMinX, float worldMinZ) const
+    {
+        GenTile& tile = tiles[index];
+
+        std::vector<const GenTile*> neighbors;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int nx = tile.tx + dx, nz = tile.tz + dz;
+                if ((dx == 0 && dz == 0) || nx < 0 || nz < 0 || nx >= tilesX || nz >= tilesZ) continue;
+                neighbors.push_back(&tiles[(size_t)nz * tilesX + nx]);
+            }
+        }
+
+        std::vector<CounterRng> rngs;
+        std::vector<float> accept(species_.size());
+        rngs.reserve(species_.size());
+        for (int si = 0; si < (int)species_.size(); ++si) {
+            rngs.emplace_back(seed, tile.tx, tile.tz, si);
+            // 把 density 转成每个采样点的接受概率（近似：density * cellArea）
+            accept[si] = glm::clamp(species_[si].density * baseStep * baseStep, 0.0f, 0.4f);
+        }
+
+        for (int iz = tile.iz0; iz < tile.iz1; ++iz) {
+            for (int ix = tile.ix0; ix < tile.ix1; ++ix) {
+                const float x = worldMinX + ix * baseStep;
+                const float z = worldMinZ + iz * baseStep;
+
+                for (int si = 0; si < (int)species_.size(); ++si) {
+                    const Species& sp = species_[si];
+                    if (sp.type == SpeciesType::GroundCover) continue;
+
+                    CounterRng& rng = rngs[si];
+                    if (rng.next01() > accept[si]) continue;
+
+                    // 抖动，避免网格感
+                    float px = x + (rng.next01() - 0.5f) * baseStep;
+                    float pz = z + (rng.next01() - 0.5f) * baseStep;
+                    glm::vec3 pos(px, 0.0f, pz);
+
+                    // 最小间距过滤（与已放置的所有树 / 灌木，按本物种的间距）：只看 XZ，高度留到最后批量贴地
+                    if (!checkSpacing_(tile.grid, spacingCell, sp.minSpacing, pos)) continue;
+                    bool free = true;
+                    for (const GenTile* n : neighbors) {
+                        if (!checkSpacing_(n->grid, spacingCell, sp.minSpacing, pos)) { free = false; break; }
+                    }
+                    if (!free) continue;
+
+                    Instance inst;
+                    inst.speciesIndex = si;
+                    inst.pos = pos;
+                    inst.yawRad = rng.next01() * glm::two_pi<float>();
+                    inst.uniformScale = rng.range(sp.minScaleJitter, sp.maxScaleJitter);
+
+                    tile.placed.push_back(inst);
+                    tile.grid[cellOf_(spacingCell, pos)].push_back(pos);
+                }
+            }
+        }
+    }
+
+    // ---- 贴地：instances_[first, end) 的高度用 Terrain::getHeightWorldBatch 一次算完 ----
+    void snapToTerrain_(const Terrain& terrain, size_t first) {
+        if (first >= instances_.size()) return;
+        const size_t n = instances_.size() - first;
+
+        std::vector<float> xs(n), zs(n), ys(n);
+        for (size_t i = 0; i < n; ++i) {
+            xs[i] = instances_[first + i].pos.x;
+            zs[i] = instances_[first + i].pos.z;
+        }
+        terrain.getHeightWorldBatch(xs.data(), zs.data(), ys.data(), n);
+        for (size_t i = 0; i < n; ++i) {
+            instances_[first + i].pos.y = ys[i];
+        }
+    }
+
+    // 树（果树 / 阔叶 / 针叶）远处改画 impostor
+    static bool usesImpostor_(SpeciesType type) {
+        return type == SpeciesType::OrchardFruit || type == SpeciesType::DeciduousTree || type == SpeciesType::ConiferTree;
+    }
+
+    bool hasImpostor_(int si) const {
+        return si < (int)impostors_.size() && impostors_[si] && impostors_[si]->isBaked();
+    }
+
+    // 把物种数组中 [first, first + count) 的预计算数据追加到本帧的上传缓冲
+    template<typename T>
+    static void appendRange_(std::vector<T>& dst, const std::vector<T>& src, int first, int count) {
+        dst.insert(dst.end(), src.begin() + first, src.begin() + first + count);
+    }
+
+    // 各类型的最大绘制距离（网格）
+    static float maxDrawDistance_(SpeciesType type) {
+        switch (type) {
+        case SpeciesType::GroundCover: return 140.0f;
+        case SpeciesType::Shrub:       return 250.0f;
+        default:                       return 800.0f;
+        }
+    }
+
+    // ---- 空间格子：实例按 (最大绘制距离, 格子 z, 格子 x, 物种) 重排，每个格子在 instances_ 中连续 ----
+    // 最大绘制距离不同的实例不进同一个格子，花草格子在 140 外就整格跳过，不会被同格的树拖住；
+    // 格内再按物种分段，各段在物种矩阵数组中也连续
+    void rebuildSpatialIndex_() {
+        struct Key { float maxDist; int z, x; };
+        auto keyOf = [&](const Instance& inst) {
+            return Key{ maxDrawDistance_(species_[inst.speciesIndex].type),
+                (int)std::floor(inst.pos.z / CELL_SIZE), (int)std::floor(inst.pos.x / CELL_SIZE) };
+        };
+        auto less = [](const Key& a, const Key& b) {
+            if (a.maxDist != b.maxDist) return a.maxDist < b.maxDist;
+            if (a.z != b.z) return a.z < b.z;
+            return a.x < b.x;
+        };
+
+        // 稳定排序：同一格子内保持生成顺序，结果与生成过程一一对应、可复现
+        std::vector<Key> keys(instances_.size());
+        std::vector<int> order(instances_.size());
+        for (size_t i = 0; i < instances_.size(); ++i) {
+            keys[i] = keyOf(instances_[i]);
+            order[i] = (int)i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            if (less(keys[a], keys[b])) return true;
+            if (less(keys[b], keys[a])) return false;
+            return instances_[a].speciesIndex < instances_[b].speciesIndex;
+        });
+
+        std::vector<Instance> sorted;
+        sorted.reserve(instances_.size());
+        for (int i : order) sorted.push_back(instances_[i]);
+        instances_.swap(sorted);
+
+        rebuildInstanceBounds_();
+        bakeMatrices_();
+
+        // 相邻且 key 相同的实例合成一个格子，格子 AABB 为其实例 AABB 的并；格内同物种的实例合成一段
+        cells_.clear();
+        runs_.clear();
+        for (int i = 0; i < (int)instances_.size(); ++i) {
+            const Key& k = keys[order[i]];
+            const Instance& inst = instances_[i];
+            AABB box = instanceBounds_.get(i);
+            bool newCell = (i == 0 || less(keys[order[i - 1]], k));
+            if (newCell) {
+                cells_.push_back({ box, k.maxDist, usesImpostor_(species_[inst.speciesIndex].type), i, 0, (int)runs_.size(), 0 });
+            }
+            Cell& cell = cells_.back();
+            cell.bounds.min = glm::min(cell.bounds.min, box.min);
+            cell.bounds.max = glm::max(cell.bounds.max, box.max);
+            ++cell.count;
+
+            if (newCell || runs_.back().species != inst.speciesIndex) {
+                runs_.push_back({ inst.speciesIndex, inst.slot, 0 });
+                ++cell.runCount;
+            }
+            ++runs_.back().count;
+        }
+    }
+
+    // ---- 预计算每个实例的最终模型矩阵与 impostor 参数 ----
+    // 放置完成后不再变化：按 instances_ 的顺序写入所属物种的连续数组，Instance::slot 记录下标
+    void bakeMatrices_() {
+        speciesMatrices_.assign(species_.size(), {});
+        speciesImpostors_.assign(species_.size(), {});
+        for (auto& inst : instances_) {
+            const Species& sp = species_[inst.speciesIndex];
+
+            // 归一到 targetHeight
+            float scale = inst.uniformScale;
+            glm::mat4 normalize(1.0f);
+            glm::vec3 center(0.0f), size(sp.targetHeight);
+            if (inst.speciesIndex < (int)models_.size()) {
+                const Model& model = *models_[inst.speciesIndex];
+                float h = model.getAabbHeight();
+                scale *= (h > 1e-6f) ? (sp.targetHeight / h) : 1.0f;
+                normalize = model.getNormalizeTransform(true, true);
+                center = model.getAabbCenter();
+                size = model.getAabbSize();
+            }
+
+            // 1. 模型空间：归一化 + 缩放
+            glm::mat4 local = glm::scale(glm::mat4(1.0f), glm::vec3(scale)) * normalize;
+
+            // 2. 世界空间：旋转 + 平移
+            glm::mat4 M(1.0f);
+            M = glm::translate(M, inst.pos);
+            M = glm::rotate(M, inst.yawRad, { 0, 1, 0 });
+
+            // 3. 合成
+            std::vector<glm::mat4>& dst = speciesMatrices_[inst.speciesIndex];
+            inst.slot = (int)dst.size();
+            dst.push_back(M * local);
+
+            // impostor：模型 AABB 中心落到世界后的位置 + 缩放后的包围球半径
+            ImpostorInstance imp;
+            imp.center = glm::vec3(dst.back() * glm::vec4(center, 1.0f));
+            imp.radius = 0.5f * glm::length(size) * scale;
+            imp.yaw = inst.yawRad;
+            speciesImpostors_[inst.speciesIndex].push_back(imp);
+        }
+    }
+
+    // ---- 实例包围盒（视锥裁剪用）----
+    // 由模型 AABB 按 targetHeight 归一化并乘以实例缩放；绕 Y 旋转取 XZ 外接圆，保证保守
+    void rebuildInstanceBounds_() {
+        instanceBounds_.clear();
+        instanceBounds_.reserve(instances_.size());
+        visibleInstances_.reserve(instances_.size());
+
+        for (const auto& inst : instances_) {
+            const Species& sp = species_[inst.speciesIndex];
+
+            glm::vec3 size(sp.targetHeight);
+            float scale = inst.uniformScale;
+            if (inst.speciesIndex < (int)models_.size()) {
+                const Model& model = *models_[inst.speciesIndex];
+                float h = model.getAabbHeight();
+                size = model.getAabbSize();
+                scale *= (h > 1e-6f) ? (sp.targetHeight / h) : 1.0f;
+            }
+
+            float r = 0.5f * std::sqrt(size.x * size.x + size.z * size.z) * scale;
+
+            AABB box;
+            box.min = inst.pos - glm::vec3(r, 0.0f, r);
+            box.max = inst.pos + glm::vec3(r, size.y * scale, r);
+            instanceBounds_.push_back(box);
+        }
     }
 
     // ---- random helpers ----
@@ -358,6 +809,56 @@ private:
     std::vector<std::unique_ptr<Model>> models_;
     std::vector<Instance> instances_;
 
-    std::unordered_map<CellKey, std::vector<glm::vec3>, CellKeyHash> spacingGrid_;
+    // 与 instances_ 一一对应的世界 AABB（SoA）及每帧可见列表
+    AABBSoA instanceBounds_;
+    std::vector<int> visibleInstances_;
+
+    // 空间格子：instances_[first, first + count) 落在同一格子且最大绘制距离相同
+    static constexpr float CELL_SIZE = 64.0f;
+    struct Cell {
+        AABB bounds;        // 格内实例 AABB（已含模型尺寸与缩放）的并
+        float maxDist;      // 格内实例的最大绘制距离（网格）
+        bool trees;         // 树格子：有 impostor 时绘制距离延长
+        int first;
+        int count;
+        int firstRun;       // runs_[firstRun, firstRun + runCount)
+        int runCount;
+    };
+    // 格内同一物种的一段实例：speciesMatrices_[species][first, first + count)
+    struct Run {
+        int species;
+        int first;
+        int count;
+    };
+    std::vector<Cell> cells_;
+    std::vector<Run> runs_;
+
+    // 每个物种的预计算世界矩阵与 impostor 参数（按格子顺序连续存放，可直接拷入实例缓冲）
+    std::vector<std::vector<glm::mat4>> speciesMatrices_;
+    std::vector<std::vector<ImpostorInstance>> speciesImpostors_;
+
+    // 树的 impostor（非树物种为空）与共用的绘制 shader
+    std::vector<std::unique_ptr<VegetationImpostor>> impostors_;
+    std::unique_ptr<Shader> impostorShader_;
+    float impostorDistance_ = 350.0f;
+    float impostorMaxDistance_ = 2500.0f;
+    int impostorFrames_ = 8;
+    int impostorCellPixels_ = 64;
+
+    // 网格与 impostor 共用的平行光
+    glm::vec3 lightDirection_ = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.4f));
+    glm::vec3 lightColor_{ 1.0f };
+
+    // 每个物种的实例缓冲与本帧收集到的世界矩阵
+    struct SpeciesBatch {
+        unsigned int instanceVBO = 0;
+        size_t capacity = 0;
+        std::vector<glm::mat4> matrices;
+        std::vector<ImpostorInstance> impostors;
+    };
+    std::vector<SpeciesBatch> batches_;
+    int drawCount_ = 0;
+
+    // 花坪生成用（generate 走各 tile 的 CounterRng）
     mutable std::mt19937 rng_{ 1337 };
 };
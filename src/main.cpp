@@ -182,10 +182,6 @@ int main() {
     );
     // 太阳方向（从太阳指向地面）
     glm::vec3 sunDir = glm::normalize(glm::vec3(-0.3f, -1.0f, -0.4f));
-    treeShader.use();
-    treeShader.setVec3("light.position", sunDir);
-    treeShader.setVec3("light.color", glm::vec3(1.0f));
-    treeShader.setVec3("viewPos", camera.Position);
 
     AniModel cat1((std::string(ASSETS_FOLDER) + "munchkin_cat2/scene.gltf").c_str(), (std::string(ASSETS_FOLDER) + "munchkin_cat2/").c_str());
     glm::vec3 catPos(-2.0f, 0.0f, -5.0f);//猫的初始位置
@@ -211,7 +207,7 @@ int main() {
         1800.0f,
         64, 64, 33, 1.0f
     );
-    terrain.setLODDistances(200.0f, 600.0f, 1400.0f);
+    terrain.setLODPixelError(2.0f); // 屏幕空间误差 LOD；距离阈值版本为 setLODDistances(200, 600, 1400)
 
     auto vegetation = CreateDefaultVegetationManager(
         terrain,
@@ -221,6 +217,8 @@ int main() {
         { 10.0f, 10.0f },   // flowerCenter
         10.0f   // flowerRadius
     );
+    // 树的网格与 impostor 共用同一个太阳光，每帧由 render 设置
+    vegetation->setLight(sunDir, glm::vec3(1.0f));
 
     // ———————— 渲染循环 ————————
     while (!glfwWindowShouldClose(window)) {
@@ -13,10 +13,10 @@ uniform mat4 projection;
 
 void main()
 {
-    //  aPos Ѿ CPU  Morph ƫƺλ
+    // 这里的 aPos 已经是 CPU 计算完 Morph 偏移后的位置
     FragPos = vec3(model * vec4(aPos, 1.0));
     
-    // ߣ򵥴δǷͳһţ
+    // 传导法线（简单处理，未考虑非统一缩放）
     Normal = mat3(transpose(inverse(model))) * aNormal;  
     
     TexCoords = aTexCoords;
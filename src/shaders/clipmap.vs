@@ -0,0 +1,89 @@
+#version 330 core
+
+// 几何 clipmap：每层同一张 (K+1)x(K+1) 网格，位置由 gl_VertexID 重建，高度从环形更新的纹理数组取
+// 输出与 terrain.vs 一致，直接复用 terrain.fs 的材质
+out VS_OUT {
+    vec3 FragPos;
+    vec3 Normal;
+    vec2 TexCoords;
+} vs_out;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+// ---- clipmap 参数（TerrainClipmap::render 设置）----
+uniform int   uClipCells;      // K：每层每边单元数
+uniform int   uClipTexMask;    // 环形纹理边长 - 1
+uniform int   uLevel;          // 当前层，格距 = uGridScale * 2^uLevel
+uniform ivec2 uLevelOrigin;    // 本层网格原点（本层格点坐标）
+uniform float uMorph;          // 1 = 外边界向粗一层过渡；最粗层为 0
+uniform float uMorphCells;     // 过渡带宽度（单元）
+uniform sampler2DArray uClipHeights;   // R16，每层一片
+
+uniform float uGridScale;
+uniform float uHeightScale;
+uniform vec2  uHalfExtent;     // 地形世界半宽 / 半长
+uniform vec2  uInvGridSize;    // 1 / (heightmap 宽 - 1), 1 / (heightmap 高 - 1)
+uniform vec2  uMaxGrid;        // heightmap 宽 - 1, 高 - 1
+
+// 本层格点 p 的归一化高度（环形寻址）
+float clipHeight(ivec2 p)
+{
+    return texelFetch(uClipHeights, ivec3(p & uClipTexMask, uLevel), 0).r;
+}
+
+void main()
+{
+    int K = uClipCells;
+    ivec2 local = ivec2(gl_VertexID % (K + 1), gl_VertexID / (K + 1));
+    ivec2 p = uLevelOrigin + local;
+    float cell = uGridScale * float(1 << uLevel);
+
+    // 与 TerrainNormalField 相同的中央差分
+    float h  = clipHeight(p);
+    float hl = clipHeight(p + ivec2(-1, 0));
+    float hr = clipHeight(p + ivec2( 1, 0));
+    float hu = clipHeight(p + ivec2( 0, -1));
+    float hd = clipHeight(p + ivec2( 0, 1));
+    vec3 normal = normalize(vec3((hl - hr) * uHeightScale, 2.0 * cell, (hu - hd) * uHeightScale));
+
+    // 过渡带：越靠近本层外边界，越接近粗一层（偶数格点）在此处的插值；边界上 alpha = 1，与粗层的边完全重合
+    int d = min(min(local.x, K - local.x), min(local.y, K - local.y));
+    float alpha = uMorph * clamp(1.0 - float(d) / uMorphCells, 0.0, 1.0);
+    if (alpha > 0.0) {
+        bool oddX = (p.x & 1) != 0;
+        bool oddZ = (p.y & 1) != 0;
+        float coarse = h;
+        if (oddX && oddZ)
+            coarse = 0.5 * (clipHeight(p + ivec2(1, -1)) + clipHeight(p + ivec2(-1, 1)));  // 粗单元的对角线 tr - bl
+        else if (oddX)
+            coarse = 0.5 * (hl + hr);
+        else if (oddZ)
+            coarse = 0.5 * (hu + hd);
+        h = mix(h, coarse, alpha);
+
+        vec3 coarseNormal = normalize(vec3(
+            (clipHeight(p + ivec2(-2, 0)) - clipHeight(p + ivec2(2, 0))) * uHeightScale,
+            4.0 * cell,
+            (clipHeight(p + ivec2(0, -2)) - clipHeight(p + ivec2(0, 2))) * uHeightScale));
+        normal = normalize(mix(normal, coarseNormal, alpha));
+    }
+
+    // heightmap 网格坐标；地形外的顶点压到边缘，那里的三角形退化为零面积
+    vec2 hg = clamp(vec2(p) * float(1 << uLevel), vec2(0.0), uMaxGrid);
+
+    vec3 aPos = vec3(
+        hg.x * uGridScale - uHalfExtent.x,
+        h * uHeightScale,
+        hg.y * uGridScale - uHalfExtent.y
+    );
+
+    vec4 FragPos = model * vec4(aPos, 1.0);
+    vs_out.FragPos = FragPos.xyz;
+
+    vs_out.Normal = mat3(transpose(inverse(model))) * normal;
+    vs_out.TexCoords = hg * uInvGridSize;
+
+    gl_Position = projection * view * FragPos;
+}
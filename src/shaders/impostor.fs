@@ -0,0 +1,73 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 CellUV;
+flat in vec2 Cell;
+in vec3 FragPos;
+in vec3 ViewPos;
+flat in float Radius;
+flat in vec2 YawCS;
+
+uniform mat4 projection;
+uniform vec3 viewPos;
+uniform float uFrames;
+uniform sampler2D uAlbedo;
+uniform sampler2D uNormalDepth;
+
+struct Light {
+    vec3 direction;
+    vec3 color;
+};
+uniform Light light;
+
+void main()
+{
+    // the reprojected quad can reach outside the chosen cell near its corners
+    if (any(lessThan(CellUV, vec2(0.0))) || any(greaterThan(CellUV, vec2(1.0)))) discard;
+
+    vec2 uv = (Cell + CellUV) / uFrames;
+    vec4 albedoCov = texture(uAlbedo, uv);
+    if (albedoCov.a < 0.5) discard;
+
+    // atlas texels are weighted by coverage: divide it back out
+    vec4 nd = texture(uNormalDepth, uv) / albedoCov.a;
+    vec3 albedo = albedoCov.rgb / albedoCov.a;
+
+    // model-space normal -> world (yaw about +Y)
+    vec3 n = nd.xyz * 2.0 - 1.0;
+    vec3 N = normalize(vec3(YawCS.x * n.x + YawCS.y * n.z, n.y, -YawCS.y * n.x + YawCS.x * n.z));
+
+    // baked depth is measured from 2 * radius in front of the center: push the fragment back along the view ray
+    float depthOffset = nd.a * 4.0 * Radius - 2.0 * Radius;
+    vec3 p = ViewPos + normalize(ViewPos) * depthOffset;
+    vec4 clip = projection * vec4(p, 1.0);
+    gl_FragDepth = clamp(clip.z / clip.w * 0.5 + 0.5, 0.0, 1.0);
+
+    // same lighting as tree.fs
+    vec3 L = normalize(-light.direction);
+    vec3 V = normalize(viewPos - FragPos);
+    vec3 H = normalize(L + V);
+
+    float up = clamp(N.y * 0.5 + 0.5, 0.0, 1.0);
+    vec3 skyColor = vec3(0.65, 0.75, 0.95);
+    vec3 groundColor = vec3(0.25, 0.22, 0.18);
+    vec3 hemi = mix(groundColor, skyColor, up);
+    vec3 ambient = hemi * albedo * 0.75;
+
+    float ndl = dot(N, L);
+    float wrap = 0.35;
+    float diff = clamp((ndl + wrap) / (1.0 + wrap), 0.0, 1.0);
+    vec3 diffuse = diff * albedo * light.color;
+
+    float back = clamp(dot(-N, L), 0.0, 1.0);
+    vec3 subsurface = back * albedo * light.color * 0.25;
+
+    float specPow = 32.0;
+    float spec = pow(max(dot(N, H), 0.0), specPow);
+    vec3 specular = spec * light.color * 0.18;
+
+    vec3 color = ambient + diffuse + subsurface + specular;
+    color *= 1.70;
+
+    FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,72 @@
+#version 330 core
+// per-instance: world center + bounding radius, yaw (no per-vertex attributes)
+layout (location = 3) in vec4 aCenterRadius;
+layout (location = 4) in float aYaw;
+
+out vec2 CellUV;        // position inside the chosen atlas cell, [0, 1] when covered
+flat out vec2 Cell;     // chosen atlas cell
+out vec3 FragPos;       // world position on the quad
+out vec3 ViewPos;       // view-space position on the quad
+flat out float Radius;
+flat out vec2 YawCS;    // cos / sin of the instance yaw
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec3 viewPos;
+uniform float uFrames;
+
+// must match VegetationImpostor::hemiOctEncode / hemiOctDecode
+vec2 hemiOctEncode(vec3 d)
+{
+    vec2 p = d.xz / (abs(d.x) + abs(d.y) + abs(d.z));
+    return vec2(p.x + p.y, p.x - p.y);
+}
+
+vec3 hemiOctDecode(vec2 uv)
+{
+    vec2 p = vec2(uv.x + uv.y, uv.x - uv.y) * 0.5;
+    return normalize(vec3(p.x, 1.0 - abs(p.x) - abs(p.y), p.y));
+}
+
+// world -> model space: inverse of the yaw rotation about +Y
+vec3 toModel(vec3 v, vec2 cs)
+{
+    return vec3(cs.x * v.x - cs.y * v.z, v.y, cs.y * v.x + cs.x * v.z);
+}
+
+void main()
+{
+    vec3 center = aCenterRadius.xyz;
+    float radius = aCenterRadius.w;
+    vec2 cs = vec2(cos(aYaw), sin(aYaw));
+
+    // 1) camera direction in model space -> nearest baked view
+    vec3 toEye = toModel(viewPos - center, cs);
+    toEye.y = max(toEye.y, 0.0);
+    if (dot(toEye, toEye) < 1e-8) toEye = vec3(0.0, 1.0, 0.0);
+    vec2 grid = clamp(floor((hemiOctEncode(normalize(toEye)) * 0.5 + 0.5) * uFrames), vec2(0.0), vec2(uFrames - 1.0));
+    vec3 dir = hemiOctDecode((grid + 0.5) / uFrames * 2.0 - 1.0);
+
+    // bake camera basis for that view (same as VegetationImpostor::bake)
+    vec3 right = cross(vec3(0.0, 1.0, 0.0), dir);
+    right = (dot(right, right) < 1e-8) ? vec3(1.0, 0.0, 0.0) : normalize(right);
+    vec3 up = cross(dir, right);
+
+    // 2) camera-facing quad around the bounding sphere (corners from gl_VertexID, triangle strip)
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1) * 2.0 - 1.0;
+    vec3 camRight = vec3(view[0][0], view[1][0], view[2][0]);
+    vec3 camUp = vec3(view[0][1], view[1][1], view[2][1]);
+    vec3 offset = (corner.x * camRight + corner.y * camUp) * radius;
+
+    // 3) project the quad corner onto the baked view's image plane
+    vec3 local = toModel(offset, cs) / radius;
+    CellUV = vec2(dot(local, right), dot(local, up)) * 0.5 + 0.5;
+    Cell = grid;
+
+    FragPos = center + offset;
+    ViewPos = vec3(view * vec4(FragPos, 1.0));
+    Radius = radius;
+    YawCS = cs;
+
+    gl_Position = projection * vec4(ViewPos, 1.0);
+}
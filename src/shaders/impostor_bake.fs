@@ -0,0 +1,32 @@
+#version 330 core
+layout (location = 0) out vec4 Albedo;
+layout (location = 1) out vec4 NormalDepth;
+
+in vec3 Normal;
+in vec2 TexCoords;
+in float ViewDepth;
+
+uniform sampler2D texture_diffuse1;
+uniform bool hasTexture;
+uniform vec3 Material_baseColor;
+uniform float uDepthRange;
+
+void main()
+{
+    vec3 albedo = Material_baseColor;
+
+    if (hasTexture) {
+        vec4 tex = texture(texture_diffuse1, TexCoords);
+        // same alpha cutout as tree.fs
+        if (tex.a < 0.35) discard;
+        albedo *= tex.rgb;
+    }
+
+    // double-sided leaves: store the normal facing the bake camera
+    vec3 N = normalize(Normal);
+    if (!gl_FrontFacing) N = -N;
+
+    // background stays (0, 0, 0, 0): everything here is implicitly weighted by coverage
+    Albedo = vec4(albedo, 1.0);
+    NormalDepth = vec4(N * 0.5 + 0.5, clamp(ViewDepth / uDepthRange, 0.0, 1.0));
+}
@@ -0,0 +1,23 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+layout (location = 2) in vec2 aTexCoords;
+
+out vec3 Normal;
+out vec2 TexCoords;
+out float ViewDepth;
+
+// node transform * bake base transform (model space, centered on the bounding sphere)
+uniform mat4 model;
+uniform mat4 uView;
+uniform mat4 uProjection;
+
+void main()
+{
+    vec4 viewPos = uView * model * vec4(aPos, 1.0);
+    ViewDepth = -viewPos.z;
+    Normal = mat3(transpose(inverse(model))) * aNormal;
+    TexCoords = aTexCoords;
+
+    gl_Position = uProjection * viewPos;
+}
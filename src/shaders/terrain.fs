@@ -42,17 +42,17 @@ void main()
     vec3 highCol = texture(grassHighTex, uv).rgb;
 
     // ---------- Compute blend factor ----------
-    // ĸ߶ȣֵе
+    // 过渡中心高度：两阈值的中点
     float center = 0.5 * (grassLowMaxHeight + grassHighMinHeight);
 
-    // ɰֱֵ smoothstep ɫ
+    // 过渡半宽：避免直接用两个阈值做 smoothstep 产生“色带”
     float halfW = 0.5 * blendWidth;
 
-    // ƵŶ߽磨ùȻѣ
+    // 低频噪声用于扰动边界（让过渡自然碎裂）
     float n = texture(noiseTex, fs_in.FragPos.xz * blendNoiseScale).r;
     n = n * 2.0 - 1.0; // [-1, 1]
 
-    // Ŷжϸ߶ȡ
+    // 用噪声扰动“过渡判断高度”
     float h2 = fs_in.FragPos.y + n * (blendNoiseAmp * blendWidth);
 
     // factor: 0 -> low grass, 1 -> high grass
@@ -66,7 +66,7 @@ void main()
     // ---------- Lighting (Lambert + ambient) ----------
     float diff = max(dot(N, -normalize(lightDir)), 0.0);
     vec3 direct = diff * lightColor;
-    vec3 ambient = 0.12 * lightColor; // ɵ0.08~0.25
+    vec3 ambient = 0.12 * lightColor; // 可调：0.08~0.25
 
     vec3 color = albedo * (direct + ambient);
 
@@ -1,8 +1,10 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
+// 压缩顶点：只有量化高度与八面体法线，X/Z 与 UV 由 gl_VertexID 重建
+layout (location = 0) in float aHeight;     // [0, 1]
+layout (location = 1) in vec2  aOctNormal;  // [-1, 1]
+// 实例化（VTF）模式：每实例 (chunkX, chunkZ, lod, 0)，高度与法线从纹理取
+layout (location = 2) in ivec4 aInstance;
 
 out VS_OUT {
     vec3 FragPos;
@@ -14,14 +16,93 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 
+// ---- 地形网格参数（TerrainSystem::Draw 设置）----
+uniform int   uChunkSize;      // 每边顶点数 N
+uniform int   uChunkCountX;    // X 方向 chunk 数
+uniform int   uChunkIndex;     // 逐 chunk 绘制时的 chunk 下标；批量绘制时为 0
+uniform int   uPaged;          // 分页模式：gl_VertexID 隐含的是槽位，需查表得到 chunk
+uniform isamplerBuffer uSlotChunks;
+uniform int   uInstanced;      // 实例化模式：chunk 来自 aInstance，不读顶点属性
+uniform sampler2D uHeightTex;  // R16，与 heightmap 采样一一对应
+uniform sampler2D uNormalTex;  // RG16_SNORM 八面体法线（带 mipmap）
+uniform vec2  uInvTexSize;     // 1 / heightmap 宽, 1 / heightmap 高
+uniform float uGridScale;
+uniform float uHeightScale;
+uniform float uSkirtDepth;
+uniform vec2  uHalfExtent;     // 地形世界半宽 / 半长
+uniform vec2  uInvGridSize;    // 1 / (heightmap 宽 - 1), 1 / (heightmap 高 - 1)
+
+// 八面体解码（与 octEncodeNormal 对应，+Y 为主轴）
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e.x, 1.0 - abs(e.x) - abs(e.y), e.y);
+    if (n.y < 0.0) {
+        vec2 f = (1.0 - abs(n.zx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.z >= 0.0 ? 1.0 : -1.0);
+        n.x = f.x;
+        n.z = f.y;
+    }
+    return normalize(n);
+}
 
 void main()
 {
+    int N = uChunkSize;
+    int vertsPerChunk = N * N + 4 * (N - 1);
+
+    // 批量绘制时 gl_VertexID 含 baseVertex（= chunk 下标 * 每 chunk 顶点数）；实例化绘制没有 baseVertex
+    int chunkIndex = uChunkIndex + gl_VertexID / vertsPerChunk;
+    if (uPaged != 0) chunkIndex = texelFetch(uSlotChunks, chunkIndex).r;
+    int local = gl_VertexID % vertsPerChunk;
+
+    // chunk 内网格坐标；skirt 顶点按行优先顺序排列在 N*N 之后
+    ivec2 g;
+    float skirt = 0.0;
+    if (local < N * N) {
+        g = ivec2(local % N, local / N);
+    }
+    else {
+        int k = local - N * N;
+        skirt = 1.0;
+        if (k < N) {
+            g = ivec2(k, 0);                               // 上边 z = 0
+        }
+        else if (k < N + 2 * (N - 2)) {
+            int j = k - N;
+            g = ivec2((j % 2) * (N - 1), 1 + j / 2);       // 左右两列
+        }
+        else {
+            g = ivec2(k - N - 2 * (N - 2), N - 1);         // 下边 z = N-1
+        }
+    }
+
+    // 全局 heightmap 网格坐标
+    ivec2 chunk = ivec2(chunkIndex % uChunkCountX, chunkIndex / uChunkCountX);
+    if (uInstanced != 0) chunk = aInstance.xy;
+    ivec2 texel = chunk * (N - 1) + g;
+    vec2 hg = vec2(texel);
+
+    // 高度 / 法线：压缩顶点属性，或实例化模式下从纹理取（粗 LOD 用对应层 mip 的法线）
+    float height = aHeight;
+    vec3 normal;
+    if (uInstanced != 0) {
+        height = texelFetch(uHeightTex, texel, 0).r;
+        normal = octDecode(textureLod(uNormalTex, (hg + 0.5) * uInvTexSize, float(aInstance.z)).rg);
+    }
+    else {
+        normal = octDecode(aOctNormal);
+    }
+
+    vec3 aPos = vec3(
+        hg.x * uGridScale - uHalfExtent.x,
+        height * uHeightScale - skirt * uSkirtDepth,
+        hg.y * uGridScale - uHalfExtent.y
+    );
+
     vec4 FragPos = model * vec4(aPos, 1.0);
     vs_out.FragPos = FragPos.xyz;
 
-    vs_out.Normal = mat3(transpose(inverse(model))) * aNormal;
-    vs_out.TexCoords = aTexCoords;
+    vs_out.Normal = mat3(transpose(inverse(model))) * normal;
+    vs_out.TexCoords = hg * uInvGridSize;
 
     gl_Position = projection * view * FragPos;
 }
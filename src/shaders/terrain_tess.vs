@@ -0,0 +1,30 @@
+#version 400 core
+
+// 硬件细分模式：每个 chunk 切成 P x P 个四边形 patch，这里只输出 patch 角点
+// 角点由 gl_VertexID（patch 下标 * 4 + 角点）与每实例的 chunk 坐标重建，高度取自高度纹理
+layout (location = 2) in ivec4 aInstance;   // (chunkX, chunkZ, 0, 0)
+
+out vec2 vGrid;     // heightmap 网格坐标
+
+uniform int   uChunkSize;       // 每边顶点数 N
+uniform int   uPatchesPerSide;  // P
+uniform sampler2D uHeightTex;   // R16，与 heightmap 采样一一对应
+uniform float uGridScale;
+uniform float uHeightScale;
+uniform vec2  uHalfExtent;
+
+void main()
+{
+    int P = uPatchesPerSide;
+    int cells = (uChunkSize - 1) / P;
+    int patchIndex = gl_VertexID / 4;
+    int corner = gl_VertexID % 4;   // 0 = (0, 0), 1 = (1, 0), 2 = (0, 1), 3 = (1, 1)
+
+    ivec2 g = aInstance.xy * (uChunkSize - 1)
+        + (ivec2(patchIndex % P, patchIndex / P) + ivec2(corner & 1, corner >> 1)) * cells;
+    vGrid = vec2(g);
+
+    // 世界坐标（未乘 model），供 TCS 计算屏幕边长
+    float height = texelFetch(uHeightTex, g, 0).r * uHeightScale;
+    gl_Position = vec4(vGrid.x * uGridScale - uHalfExtent.x, height, vGrid.y * uGridScale - uHalfExtent.y, 1.0);
+}